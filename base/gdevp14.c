@@ -70,6 +70,9 @@
 #endif
 #include "assert_.h"
 #include "gxgetbit.h"
+#include "gpsync.h"
+#include "gxsync.h"
+#include "gxclthrd.h"
 
 #if RAW_DUMP
 unsigned int global_index = 0;
@@ -151,10 +154,10 @@ typedef struct pdf14_abuf_state_s {
 } pdf14_abuf_state_t;
 
 /* Buffer stack	data structure */
-gs_private_st_ptrs7(st_pdf14_buf, pdf14_buf, "pdf14_buf",
+gs_private_st_ptrs8(st_pdf14_buf, pdf14_buf, "pdf14_buf",
                     pdf14_buf_enum_ptrs, pdf14_buf_reloc_ptrs,
                     saved, data, backdrop, transfer_fn, mask_stack,
-                    matte, group_color_info);
+                    matte, group_color_info, dirty_tiles);
 
 gs_private_st_ptrs3(st_pdf14_ctx, pdf14_ctx, "pdf14_ctx",
                     pdf14_ctx_enum_ptrs, pdf14_ctx_reloc_ptrs,
@@ -1143,6 +1146,11 @@ pdf14_buf_new(gs_int_rect *rect, bool has_tags, bool has_alpha_g,
     result->page_group = false;
     result->group_color_info = NULL;
     result->group_popped = false;
+    result->dirty_tiles = NULL;
+    result->tile_rect.p.x = rect->p.x >> PDF14_TILE_SHIFT;
+    result->tile_rect.p.y = rect->p.y >> PDF14_TILE_SHIFT;
+    result->tile_rect.q.x = result->tile_rect.p.x;
+    result->tile_rect.q.y = result->tile_rect.p.y;
 
     if (idle || height <= 0) {
         /* Empty clipping - will skip all drawings. */
@@ -1169,6 +1177,20 @@ pdf14_buf_new(gs_int_rect *rect, bool has_tags, bool has_alpha_g,
             memset (result->data + tags_plane * planestride,
                     GS_UNTOUCHED_TAG, planestride);
         }
+        if (rect->q.x > rect->p.x) {
+            /* The tile map is only an optimisation; without it we compose
+               the whole of the dirty rectangle. */
+            result->tile_rect.q.x = ((rect->q.x - 1) >> PDF14_TILE_SHIFT) + 1;
+            result->tile_rect.q.y = ((rect->q.y - 1) >> PDF14_TILE_SHIFT) + 1;
+            result->dirty_tiles = gs_alloc_bytes(memory,
+                        (size_t)(result->tile_rect.q.x - result->tile_rect.p.x) *
+                        (result->tile_rect.q.y - result->tile_rect.p.y),
+                        "pdf14_buf_new");
+            if (result->dirty_tiles != NULL)
+                memset(result->dirty_tiles, 0,
+                       (size_t)(result->tile_rect.q.x - result->tile_rect.p.x) *
+                       (result->tile_rect.q.y - result->tile_rect.p.y));
+        }
     }
     /* Initialize dirty box with an invalid rectangle (the reversed rectangle).
      * Any future drawing will make it valid again, so we won't blend back
@@ -1193,6 +1215,7 @@ pdf14_buf_free(pdf14_buf *buf)
     gs_free_object(memory, buf->transfer_fn, "pdf14_buf_free");
     gs_free_object(memory, buf->matte, "pdf14_buf_free");
     gs_free_object(memory, buf->data, "pdf14_buf_free");
+    gs_free_object(memory, buf->dirty_tiles, "pdf14_buf_free");
 
     while (group_color_info) {
        if (group_color_info->icc_profile != NULL) {
@@ -1207,6 +1230,229 @@ pdf14_buf_free(pdf14_buf *buf)
     gs_free_object(memory, buf, "pdf14_buf_free");
 }
 
+void
+pdf14_buf_mark_dirty(pdf14_buf *buf, int x, int y, int w, int h)
+{
+    int tw = buf->tile_rect.q.x - buf->tile_rect.p.x;
+    int tx0, tx1, ty0, ty1;
+    byte *row;
+
+    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
+    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
+    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
+    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+
+    if (buf->dirty_tiles == NULL || w <= 0 || h <= 0)
+        return;
+    tx0 = max(x >> PDF14_TILE_SHIFT, buf->tile_rect.p.x);
+    tx1 = min(((x + w - 1) >> PDF14_TILE_SHIFT) + 1, buf->tile_rect.q.x);
+    ty0 = max(y >> PDF14_TILE_SHIFT, buf->tile_rect.p.y);
+    ty1 = min(((y + h - 1) >> PDF14_TILE_SHIFT) + 1, buf->tile_rect.q.y);
+    if (tx0 >= tx1)
+        return;
+    row = buf->dirty_tiles + (ty0 - buf->tile_rect.p.y) * (size_t)tw +
+          (tx0 - buf->tile_rect.p.x);
+    for (; ty0 < ty1; ty0++, row += tw)
+        memset(row, 1, tx1 - tx0);
+}
+
+/* When the band is being rendered by a clist render thread, large group
+   compositions are split into horizontal slices that are composed by
+   helper threads alongside the calling one. Every row is composed exactly
+   as it would be by a single call, so the result does not depend on the
+   split. Slices are whole tile rows, so each thread only touches its own
+   part of the dirty tile map of nos. */
+#define PDF14_COMPOSE_MAX_THREADS 8
+#define PDF14_COMPOSE_MIN_SLICE_AREA (128 * 1024)
+
+typedef struct pdf14_compose_slice_s {
+    pdf14_buf *tos;
+    pdf14_buf *nos;
+    pdf14_buf *maskbuf;
+    int x0, x1, y0, y1;
+    int n_chan;
+    bool additive;
+    const pdf14_nonseparable_blending_procs_t *pblend_procs;
+    bool has_matte;
+    bool overprint;
+    gx_color_index drawn_comps;
+    gs_memory_t *memory;
+    gx_device *dev;
+} pdf14_compose_slice_t;
+
+static void
+pdf14_compose_slice(void *arg)
+{
+    pdf14_compose_slice_t *slice = (pdf14_compose_slice_t *)arg;
+
+    pdf14_compose_group(slice->tos, slice->nos, slice->maskbuf,
+                        slice->x0, slice->x1, slice->y0, slice->y1,
+                        slice->n_chan, slice->additive, slice->pblend_procs,
+                        slice->has_matte, slice->overprint,
+                        slice->drawn_comps, slice->memory, slice->dev);
+}
+
+/* Return the number of slices the area should be composed in. */
+static int
+pdf14_compose_slice_count(gx_device *dev, int x0, int x1, int y0, int y1)
+{
+    pdf14_device *pdev = (pdf14_device *)dev;
+    gx_device_clist_reader *pcrdev;
+    int64_t area = (int64_t)(x1 - x0) * (y1 - y0);
+    int count, tile_rows;
+
+#if RAW_DUMP
+    return 1;
+#endif
+    if (pdev->pclist_device == NULL)
+        return 1;
+    pcrdev = (gx_device_clist_reader *)(pdev->pclist_device);
+    /* Only the device of a clist render thread that is rendering a band
+       (ymin >= 0) has threads to borrow. */
+    if (pcrdev->ymin < 0 || pcrdev->compose_budget == NULL)
+        return 1;
+    count = PDF14_COMPOSE_MAX_THREADS;
+    if (area / count < PDF14_COMPOSE_MIN_SLICE_AREA)
+        count = (int)(area / PDF14_COMPOSE_MIN_SLICE_AREA);
+    tile_rows = ((y1 - 1) >> PDF14_TILE_SHIFT) - (y0 >> PDF14_TILE_SHIFT) + 1;
+    if (count > tile_rows)
+        count = tile_rows;
+    return max(count, 1);
+}
+
+static void
+pdf14_compose_group_sliced(pdf14_buf *tos, pdf14_buf *nos, pdf14_buf *maskbuf,
+              int x0, int x1, int y0, int y1, int n_chan, bool additive,
+              const pdf14_nonseparable_blending_procs_t * pblend_procs,
+              bool has_matte, bool overprint, gx_color_index drawn_comps,
+              gs_memory_t *memory, gx_device *dev)
+{
+    pdf14_compose_slice_t slices[PDF14_COMPOSE_MAX_THREADS];
+    gp_thread_id threads[PDF14_COMPOSE_MAX_THREADS];
+    gx_device_clist_reader *pcrdev = NULL;
+    int count = pdf14_compose_slice_count(dev, x0, x1, y0, y1);
+    int tile_rows, i, y;
+
+    /* Only use threads that no band is being rendered with, so that the
+       render threads and their helpers never outnumber the threads the
+       page was to be rendered with. */
+    if (count > 1 && tos->n_chan != 0 && nos->n_chan != 0) {
+        pcrdev = (gx_device_clist_reader *)(((pdf14_device *)dev)->pclist_device);
+        count = clist_compose_threads_reserve(pcrdev, count - 1) + 1;
+    }
+    if (count < 2 || tos->n_chan == 0 || nos->n_chan == 0) {
+        pdf14_compose_group(tos, nos, maskbuf, x0, x1, y0, y1, n_chan,
+                            additive, pblend_procs, has_matte, overprint,
+                            drawn_comps, memory, dev);
+        return;
+    }
+
+    /* Do the bookkeeping that every slice would otherwise repeat, so that
+       the slices leave the shared rectangles alone. */
+    rect_merge(nos->dirty, tos->dirty);
+    pdf14_buf_mark_dirty(nos, x0, y0, x1 - x0, y1 - y0);
+
+    tile_rows = ((y1 - 1) >> PDF14_TILE_SHIFT) - (y0 >> PDF14_TILE_SHIFT) + 1;
+    y = y0;
+    for (i = 0; i < count; i++) {
+        pdf14_compose_slice_t *slice = &slices[i];
+        int end_row = (y0 >> PDF14_TILE_SHIFT) + (int)((int64_t)tile_rows * (i + 1) / count);
+
+        slice->tos = tos;
+        slice->nos = nos;
+        slice->maskbuf = maskbuf;
+        slice->x0 = x0;
+        slice->x1 = x1;
+        slice->y0 = y;
+        slice->y1 = (i == count - 1) ? y1 : min(y1, end_row << PDF14_TILE_SHIFT);
+        slice->n_chan = n_chan;
+        slice->additive = additive;
+        slice->pblend_procs = pblend_procs;
+        slice->has_matte = has_matte;
+        slice->overprint = overprint;
+        slice->drawn_comps = drawn_comps;
+        slice->memory = memory;
+        slice->dev = dev;
+        y = slice->y1;
+    }
+
+    /* Slice 0 is ours; any slice that cannot get a thread is composed here
+       as well. */
+    for (i = 1; i < count; i++) {
+        if (gp_thread_start(pdf14_compose_slice, &slices[i], &threads[i]) < 0) {
+            threads[i] = NULL;
+            pdf14_compose_slice(&slices[i]);
+        }
+    }
+    pdf14_compose_slice(&slices[0]);
+    for (i = 1; i < count; i++) {
+        if (threads[i] != NULL)
+            gp_thread_finish(threads[i]);
+    }
+    clist_compose_threads_release(pcrdev, count - 1);
+}
+
+/* Compose the area (x0,y0)-(x1,y1) of tos onto nos, skipping the tiles of
+   tos that were never marked. Runs of marked tiles along a tile row are
+   composed in one go, and an area that is fully marked is composed with a
+   single call, exactly as if no tile map was present. */
+static void
+pdf14_compose_group_tiles(pdf14_buf *tos, pdf14_buf *nos, pdf14_buf *maskbuf,
+              int x0, int x1, int y0, int y1, int n_chan, bool additive,
+              const pdf14_nonseparable_blending_procs_t * pblend_procs,
+              bool has_matte, bool overprint, gx_color_index drawn_comps,
+              gs_memory_t *memory, gx_device *dev)
+{
+    int tw = tos->tile_rect.q.x - tos->tile_rect.p.x;
+    int tx0 = 0, tx1 = 0, ty0 = 0, ty1 = 0, tx, ty, run;
+    const byte *row;
+    bool full = true;
+
+    if (tos->dirty_tiles != NULL) {
+        tx0 = max(x0 >> PDF14_TILE_SHIFT, tos->tile_rect.p.x);
+        tx1 = min(((x1 - 1) >> PDF14_TILE_SHIFT) + 1, tos->tile_rect.q.x);
+        ty0 = max(y0 >> PDF14_TILE_SHIFT, tos->tile_rect.p.y);
+        ty1 = min(((y1 - 1) >> PDF14_TILE_SHIFT) + 1, tos->tile_rect.q.y);
+        /* Only trust the map if it covers the whole area */
+        full = (tx0 << PDF14_TILE_SHIFT) > x0 || (tx1 << PDF14_TILE_SHIFT) < x1 ||
+               (ty0 << PDF14_TILE_SHIFT) > y0 || (ty1 << PDF14_TILE_SHIFT) < y1;
+        for (ty = ty0; ty < ty1 && !full; ty++) {
+            row = tos->dirty_tiles + (ty - tos->tile_rect.p.y) * (size_t)tw;
+            if (memchr(row + tx0 - tos->tile_rect.p.x, 0, tx1 - tx0) != NULL)
+                break;
+        }
+        if (ty == ty1)
+            full = true;
+    }
+    if (full) {
+        pdf14_compose_group_sliced(tos, nos, maskbuf, x0, x1, y0, y1, n_chan,
+                                   additive, pblend_procs, has_matte, overprint,
+                                   drawn_comps, memory, dev);
+        return;
+    }
+
+    for (ty = ty0; ty < ty1; ty++) {
+        int ry0 = max(y0, ty << PDF14_TILE_SHIFT);
+        int ry1 = min(y1, (ty + 1) << PDF14_TILE_SHIFT);
+
+        row = tos->dirty_tiles + (ty - tos->tile_rect.p.y) * (size_t)tw -
+              tos->tile_rect.p.x;
+        for (tx = tx0; tx < tx1; tx = run) {
+            if (!row[tx]) {
+                run = tx + 1;
+                continue;
+            }
+            for (run = tx + 1; run < tx1 && row[run]; run++)
+                ;
+            pdf14_compose_group(tos, nos, maskbuf,
+                                max(x0, tx << PDF14_TILE_SHIFT),
+                                min(x1, run << PDF14_TILE_SHIFT), ry0, ry1,
+                                n_chan, additive, pblend_procs, has_matte,
+                                overprint, drawn_comps, memory, dev);
+        }
+    }
+}
+
 static void
 rc_pdf14_maskbuf_free(gs_memory_t * mem, void *ptr_in, client_name_t cname)
 {
@@ -1637,6 +1883,16 @@ pdf14_pop_transparency_group(gs_gstate *pgs, pdf14_ctx *ctx,
             nos->rect.q.x, nos->rect.q.y, nos->n_chan, nos->n_planes);
 
         nos->dirty = tos->dirty;
+        if (nos->dirty_tiles != NULL) {
+            if (tos->dirty_tiles != NULL)
+                memcpy(nos->dirty_tiles, tos->dirty_tiles,
+                       (size_t)(nos->tile_rect.q.x - nos->tile_rect.p.x) *
+                       (nos->tile_rect.q.y - nos->tile_rect.p.y));
+            else
+                pdf14_buf_mark_dirty(nos, nos->dirty.p.x, nos->dirty.p.y,
+                                     nos->dirty.q.x - nos->dirty.p.x,
+                                     nos->dirty.q.y - nos->dirty.p.y);
+        }
         nos->isolated = tos->isolated;
         nos->knockout = tos->knockout;
         nos->alpha = 65535;
@@ -1741,10 +1997,12 @@ pdf14_pop_transparency_group(gs_gstate *pgs, pdf14_ctx *ctx,
                     tos->rect.q.y - tos->rect.p.y, &did_alloc, tos->deep, false);
                 has_matte = false;
             } else {
+                /* Only the marked area is composed, so only convert that. */
                 result = pdf14_transform_color_buffer_no_matte(pgs, ctx, dev,
-                    tos, tos->data, curr_icc_profile, nos->group_color_info->icc_profile,
-                    tos->rect.p.x, tos->rect.p.y, tos->rect.q.x - tos->rect.p.x,
-                    tos->rect.q.y - tos->rect.p.y, &did_alloc, tos->deep, false);
+                    tos, tos->data + ((x0 - tos->rect.p.x)<<tos->deep) +
+                    (y0 - tos->rect.p.y) * (size_t)tos->rowstride,
+                    curr_icc_profile, nos->group_color_info->icc_profile,
+                    x0, y0, x1 - x0, y1 - y0, &did_alloc, tos->deep, false);
             }
             if (result == NULL) {
                 /* Clean up and return error code */
@@ -1762,7 +2020,7 @@ pdf14_pop_transparency_group(gs_gstate *pgs, pdf14_ctx *ctx,
                             ctx->stack->deep);
 #endif
              /* compose. never do overprint in this case */
-            pdf14_compose_group(tos, nos, maskbuf, x0, x1, y0, y1, nos->n_chan,
+            pdf14_compose_group_tiles(tos, nos, maskbuf, x0, x1, y0, y1, nos->n_chan,
                  nos->group_color_info->isadditive,
                  nos->group_color_info->blend_procs,
                  has_matte, false, drawn_comps, ctx->memory, dev);
@@ -1770,9 +2028,9 @@ pdf14_pop_transparency_group(gs_gstate *pgs, pdf14_ctx *ctx,
     } else {
         /* Group color spaces are the same.  No color conversions needed */
         if (x0 < x1 && y0 < y1)
-            pdf14_compose_group(tos, nos, maskbuf, x0, x1, y0, y1, nos->n_chan,
-                                ctx->additive, pblend_procs, has_matte, overprint,
-                                drawn_comps, ctx->memory, dev);
+            pdf14_compose_group_tiles(tos, nos, maskbuf, x0, x1, y0, y1, nos->n_chan,
+                                      ctx->additive, pblend_procs, has_matte, overprint,
+                                      drawn_comps, ctx->memory, dev);
     }
 exit:
     ctx->stack = nos;
@@ -4713,10 +4971,7 @@ do_pdf14_copy_alpha_color(gx_device * dev, const byte * data, int data_x,
     if (x + w > buf->rect.q.x) w = buf->rect.q.x - x;
     if (y + h > buf->rect.q.y) h = buf->rect.q.y - y;
     /* Update the dirty rectangle. */
-    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
-    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
-    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
-    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+    pdf14_buf_mark_dirty(buf, x, y, w, h);
 
     /* composite with backdrop only. */
     line = buf->data + (x - buf->rect.p.x) + (y - buf->rect.p.y) * rowstride;
@@ -4913,10 +5168,7 @@ do_pdf14_copy_alpha_color_16(gx_device * dev, const byte * data, int data_x,
     if (x + w > buf->rect.q.x) w = buf->rect.q.x - x;
     if (y + h > buf->rect.q.y) h = buf->rect.q.y - y;
     /* Update the dirty rectangle. */
-    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
-    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
-    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
-    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+    pdf14_buf_mark_dirty(buf, x, y, w, h);
 
     /* composite with backdrop only. */
     line = buf->data + (x - buf->rect.p.x)*2 + (y - buf->rect.p.y) * rowstride;
@@ -6851,6 +7103,7 @@ pdf14_copy_planes(gx_device * dev, const byte * data, int data_x, int raster,
     fake_tos.dirty.p.y = y;
     fake_tos.dirty.q.x = x + w;
     fake_tos.dirty.q.y = y + h;
+    fake_tos.dirty_tiles = NULL;
     fake_tos.has_alpha_g = 0;
     fake_tos.has_shape = 0;
     fake_tos.has_tags = 0;
@@ -8026,10 +8279,7 @@ do_mark_fill_rectangle_ko_simple(gx_device *dev, int x, int y, int w, int h,
     if (x + w > buf->rect.q.x) w = buf->rect.q.x - x;
     if (y + h > buf->rect.q.y) h = buf->rect.q.y - y;
     /* Update the dirty rectangle with the mark. */
-    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
-    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
-    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
-    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+    pdf14_buf_mark_dirty(buf, x, y, w, h);
 
     /* composite with backdrop only. */
     if (has_backdrop)
@@ -8248,10 +8498,7 @@ do_mark_fill_rectangle_ko_simple16(gx_device *dev, int x, int y, int w, int h,
     if (x + w > buf->rect.q.x) w = buf->rect.q.x - x;
     if (y + h > buf->rect.q.y) h = buf->rect.q.y - y;
     /* Update the dirty rectangle with the mark. */
-    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
-    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
-    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
-    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+    pdf14_buf_mark_dirty(buf, x, y, w, h);
 
 
     /* composite with backdrop only. */
@@ -135,6 +135,15 @@ struct pdf14_group_color_s {
 
 typedef struct pdf14_ctx_s pdf14_ctx;
 
+/* Each buffer keeps a map of which device space aligned PDF14_TILE_SIZE
+ * square tiles have been marked, in addition to the dirty bounding box.
+ * Group composition only visits the marked tiles, so that a large group
+ * holding a few small objects far apart is not composed in its entirety.
+ * The map saves time only: the buffer data is still allocated for the
+ * whole group rectangle. */
+#define PDF14_TILE_SHIFT 6
+#define PDF14_TILE_SIZE (1 << PDF14_TILE_SHIFT)
+
 struct pdf14_buf_s {
     pdf14_buf *saved;
     byte *backdrop;  /* This is needed for proper non-isolated knockout support */
@@ -169,6 +178,8 @@ struct pdf14_buf_s {
     int matte_num_comps;
     uint16_t *matte;
     gs_int_rect dirty;
+    byte *dirty_tiles;      /* One byte per tile, NULL if not tracked */
+    gs_int_rect tile_rect;  /* Extent of dirty_tiles, in tile units */
     pdf14_mask_t *mask_stack;
     bool idle;
 
@@ -330,6 +341,9 @@ int gs_pdf14_device_color_mon_set(gx_device *pdev, bool monitoring);
 /* depth are critical since these must match when reading back colors.             */
 bool pdf14_ok_to_optimize(gx_device *bdev);
 
+/* Record a mark in the dirty rectangle and the tile map of a buffer. */
+void pdf14_buf_mark_dirty(pdf14_buf *buf, int x, int y, int w, int h);
+
 int
 pdf14_accum_dev_spec_op(gx_device *pdev, int dev_spec_op, void *data, int size);
 
@@ -765,6 +765,7 @@ ialloc_alloc_state(gs_memory_t * parent, uint clump_size)
     iimem->is_controlled = false;
     iimem->gc_status.vm_threshold = clump_size * 3L;
     iimem->gc_status.max_vm = MAX_MAX_VM;
+    iimem->gc_status.vm_growth = DEFAULT_VM_GROWTH;
     iimem->gc_status.signal_value = 0;
     iimem->gc_status.enabled = false;
     iimem->gc_status.requested = 0;
@@ -929,8 +930,18 @@ ialloc_reset_free(gs_ref_memory_t * mem)
  */
 #define FORCE_GC_LIMIT 8000000
 
+/*
+ * When the current clump is full, the allocators look for room at the end
+ * of the following clumps. In a large heap most of those are full as well,
+ * and walking them all on every clump change makes allocation slow down as
+ * the heap grows, so give up and add a new clump after this many. The
+ * space left behind is only recovered by the next GC, so the search is not
+ * limited when GC is disabled.
+ */
+#define ALLOC_CLUMP_SEARCH_LIMIT 8
+
 /* Set the allocation limit after a change in one or more of */
-/* vm_threshold, max_vm, or enabled, or after a GC. */
+/* vm_threshold, vm_growth, max_vm, or enabled, or after a GC. */
 void
 ialloc_set_limit(register gs_ref_memory_t * mem)
 {	/*
@@ -945,7 +956,20 @@ ialloc_set_limit(register gs_ref_memory_t * mem)
      0);
 
     if (mem->gc_status.enabled) {
-        size_t limit = mem->gc_allocated + mem->gc_status.vm_threshold;
+        /*
+         * When a lot of data survives each collection, collecting every
+         * vm_threshold bytes spends most of the time re-marking and
+         * compacting the same long-lived objects. So we pace collections by
+         * letting the heap grow by vm_growth percent of what survived the
+         * last one (if that is more than vm_threshold). This makes the total
+         * cost of GC proportional to the garbage rather than to the live
+         * data, at the price of a peak heap up to (100 + vm_growth)% of the
+         * live data; max_vm still caps it. Each collection still traces the
+         * whole heap, so no single GC pause is any shorter.
+         */
+        size_t growth = mem->gc_allocated / 100 * mem->gc_status.vm_growth;
+        size_t limit = mem->gc_allocated +
+            max(mem->gc_status.vm_threshold, growth);
 
         if (limit < mem->previous_status.allocated)
             mem->limit = 0;
@@ -1090,6 +1114,25 @@ gs_memory_set_vm_reclaim(gs_ref_memory_t * mem, bool enabled)
     gs_memory_set_gc_status(stable, &stat);
 }
 
+/* Set the GC pacing growth (see ialloc_set_limit). */
+void
+gs_memory_set_vm_growth(gs_ref_memory_t * mem, int percent)
+{
+    gs_memory_gc_status_t stat;
+    gs_ref_memory_t * stable = (gs_ref_memory_t *)mem->stable_memory;
+
+    if (percent < 0)
+        percent = 0;
+    else if (percent > MAX_VM_GROWTH)
+        percent = MAX_VM_GROWTH;
+    gs_memory_gc_status(mem, &stat);
+    stat.vm_growth = percent;
+    gs_memory_set_gc_status(mem, &stat);
+    gs_memory_gc_status(stable, &stat);
+    stat.vm_growth = percent;
+    gs_memory_set_gc_status(stable, &stat);
+}
+
 /* ================ Objects ================ */
 
 /* Allocate a small object quickly if possible. */
@@ -1600,6 +1643,7 @@ i_alloc_string(gs_memory_t * mem, size_t nbytes, client_name_t cname)
     gs_ref_memory_t * const imem = (gs_ref_memory_t *)mem;
     byte *str;
     clump_splay_walker sw;
+    int searched = 0;
 
     /*
      * Cycle through the clumps at the current save level, starting
@@ -1626,7 +1670,8 @@ top:
         return str;
     }
     /* Try the next clump. */
-    cp = clump_splay_walk_fwd(&sw);
+    cp = (imem->gc_status.enabled && ++searched > ALLOC_CLUMP_SEARCH_LIMIT ?
+          NULL : clump_splay_walk_fwd(&sw));
 
     if (cp != NULL)
     {
@@ -1930,6 +1975,7 @@ alloc_obj(gs_ref_memory_t *mem, obj_size_t lsize, gs_memory_type_ptr_t pstype,
         clump_t *cp = clump_splay_walk_init_mid(&sw, mem->cc);
         obj_size_t asize = obj_size_round(lsize);
         bool allocate_success = false;
+        int searched = 0;
 
         if (lsize > max_freelist_size && (flags & ALLOC_DIRECT)) {
             /* We haven't checked the large block freelist yet. */
@@ -1962,6 +2008,9 @@ alloc_obj(gs_ref_memory_t *mem, obj_size_t lsize, gs_memory_type_ptr_t pstype,
                 }
             }
             /* No luck, go on to the next clump. */
+            if (mem->gc_status.enabled &&
+                ++searched > ALLOC_CLUMP_SEARCH_LIMIT)
+                break;
             cp = clump_splay_walk_fwd(&sw);
             if (cp == NULL)
                 break;
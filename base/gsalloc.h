@@ -32,6 +32,8 @@ typedef struct gs_memory_gc_status_s {
     /* Note vm_threshold is set as a signed value */
     int64_t vm_threshold;	/* GC interval */
     size_t max_vm;		/* maximum allowed allocation */
+    int vm_growth;		/* % of the VM that survived the last GC */
+                                /* allowed before the next (if > vm_threshold) */
 
     int signal_value;		/* value to store in gs_lib_ctx->gcsignal */
     bool enabled;		/* auto GC enabled if true */
@@ -47,12 +49,16 @@ typedef struct gs_memory_gc_status_s {
 #endif
 #define MAX_MAX_VM (max_size_t>>1)
 #define MIN_VM_THRESHOLD 1
+#define DEFAULT_VM_GROWTH 50
+#define MAX_VM_GROWTH 100
 
 void gs_memory_gc_status(const gs_ref_memory_t *, gs_memory_gc_status_t *);
 void gs_memory_set_gc_status(gs_ref_memory_t *, const gs_memory_gc_status_t *);
 /* Value passed as int64_t, but limited to MAX_VM_THRESHOLD (see set_vm_threshold) */
 void gs_memory_set_vm_threshold(gs_ref_memory_t * mem, int64_t val);
 void gs_memory_set_vm_reclaim(gs_ref_memory_t * mem, bool enabled);
+/* Limited to 0..MAX_VM_GROWTH */
+void gs_memory_set_vm_growth(gs_ref_memory_t * mem, int percent);
 
 /* ------ Initialization ------ */
 
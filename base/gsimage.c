@@ -748,3 +748,53 @@ gs_image_cleanup_and_free_enum(gs_image_enum * penum, gs_gstate *pgs)
     gs_free_object(penum->memory, penum, "gs_image_cleanup_and_free_enum");
     return code;
 }
+
+/* Work out how far below full size an image is drawn. */
+int
+gs_image_reduction_denom(const gs_gstate *pgs, const gs_pixel_image_t *pim,
+                         int max_denom)
+{
+    gs_matrix mat;
+    gs_point pt;
+    double sx, sy;
+    int denom;
+
+    if (gs_matrix_invert(&pim->ImageMatrix, &mat) < 0 ||
+        gs_matrix_multiply(&mat, &ctm_only(pgs), &mat) < 0)
+        return 1;
+
+    /* Device space length of one sample step in each direction */
+    if (gs_distance_transform(1, 0, &mat, &pt) < 0)
+        return 1;
+    sx = hypot(pt.x, pt.y);
+    if (gs_distance_transform(0, 1, &mat, &pt) < 0)
+        return 1;
+    sy = hypot(pt.x, pt.y);
+
+    for (denom = max_denom; denom > 1; denom >>= 1)
+        if (sx * denom <= 1.0 && sy * denom <= 1.0)
+            break;
+    return denom;
+}
+
+/*
+ * Describe the image as it will be supplied at 1/denom size. The reduced
+ * dimensions are rounded up (as the IJG library does), so ImageMatrix is
+ * scaled by the actual ratio of the dimensions to keep the image in the
+ * same place on the page.
+ */
+int
+gs_pixel_image_reduce(gs_pixel_image_t *pim, int denom)
+{
+    gs_matrix scale;
+    int w, h;
+
+    if (denom <= 1 || pim->Width <= 0 || pim->Height <= 0)
+        return 0;
+    w = (pim->Width + denom - 1) / denom;
+    h = (pim->Height + denom - 1) / denom;
+    gs_make_scaling((double)w / pim->Width, (double)h / pim->Height, &scale);
+    pim->Width = w;
+    pim->Height = h;
+    return gs_matrix_multiply(&pim->ImageMatrix, &scale, &pim->ImageMatrix);
+}
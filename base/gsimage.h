@@ -192,4 +192,15 @@ int gs_image_cleanup(gs_image_enum * penum, gs_gstate *pgs);
 /* Clean up after processing an image and free the enumerator. */
 int gs_image_cleanup_and_free_enum(gs_image_enum * penum, gs_gstate *pgs);
 
+/*
+ * Some data sources (the DCTDecode filter) can supply an image at 1/2 or
+ * 1/4 of its full size. gs_image_reduction_denom returns the largest power
+ * of 2, up to max_denom, by which the image is reduced in both directions
+ * when drawn with the current CTM (or 1), and gs_pixel_image_reduce adjusts
+ * Width, Height and ImageMatrix to describe the image at that reduction.
+ */
+int gs_image_reduction_denom(const gs_gstate *pgs, const gs_pixel_image_t *pim,
+                             int max_denom);
+int gs_pixel_image_reduce(gs_pixel_image_t *pim, int denom);
+
 #endif /* gsimage_INCLUDED */
@@ -34,7 +34,15 @@
  */
 
 #undef BLOCK_SMOOTHING_SUPPORTED
-#undef IDCT_SCALING_SUPPORTED
+/*
+ * IDCT_SCALING_SUPPORTED is left defined, so that the DCT decode filter
+ * can decode downscaled images at reduced size. With it, IJG 9 implements
+ * "fancy" upsampling by scaling chroma up through the IDCT, which changes
+ * full size output. Every decoder (sjpegd.c, gpdl's jpgtop.c and
+ * imagetop.c, and libtiff's tif_jpeg.c) therefore turns
+ * do_fancy_upsampling off, keeping the replicating upsampler that is all
+ * the library had without IDCT scaling.
+ */
 #undef UPSAMPLE_SCALING_SUPPORTED
 #undef UPSAMPLE_MERGING_SUPPORTED
 #undef QUANT_1PASS_SUPPORTED
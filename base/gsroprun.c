@@ -98,6 +98,36 @@ static void record(int rop)
   (ptr)[1] = (byte)((uint)(pixel) >> 8),\
   (ptr)[2] = (byte)(pixel)
 
+#ifdef HAVE_SSE2
+/* Expand a 24 bit constant into the 3 vectors that cover 16 pixels. */
+static inline void rop_splat24(__m128i *v, rop_operand c)
+{
+    byte b[48];
+    int i;
+
+    for (i = 0; i < 48; i += 3)
+        put24(b + i, c);
+    v[0] = _mm_loadu_si128((const __m128i *)b);
+    v[1] = _mm_loadu_si128((const __m128i *)(b+16));
+    v[2] = _mm_loadu_si128((const __m128i *)(b+32));
+}
+#endif
+
+/* The rops that dominate PCL and PCL-XL jobs, used by the specific
+ * runs below. The MM_ versions work on 16 bytes at a time. */
+#define ROP_CA_CODE(O,D,S,T) do { O = (S & T) | (D & ~T); } while (0)
+#define ROP_CA_MM_CODE(O,D,S,T) do { __m128i t_ = (T); _mm_storeu_si128(O,_mm_or_si128(_mm_and_si128(S,t_),_mm_andnot_si128(t_,_mm_loadu_si128(D)))); } while (0 == 1)
+#define ROP_B8_CODE(O,D,S,T) do { O = (T & ~S) | (D & S); } while (0)
+#define ROP_B8_MM_CODE(O,D,S,T) do { __m128i s_ = (S); _mm_storeu_si128(O,_mm_or_si128(_mm_andnot_si128(s_,T),_mm_and_si128(s_,_mm_loadu_si128(D)))); } while (0 == 1)
+#define ROP_EE_CODE(O,D,S,T) do { O = D|S; } while (0)
+#define ROP_EE_MM_CODE(O,D,S,T) do { _mm_storeu_si128(O,_mm_or_si128(_mm_loadu_si128(D),S)); } while (0 == 1)
+#define ROP_88_CODE(O,D,S,T) do { O = D&S; } while (0)
+#define ROP_88_MM_CODE(O,D,S,T) do { _mm_storeu_si128(O,_mm_and_si128(_mm_loadu_si128(D),S)); } while (0 == 1)
+#define ROP_FC_CODE(O,D,S,T) do { O = S|T; } while (0)
+#define ROP_FC_MM_CODE(O,D,S,T) do { _mm_storeu_si128(O,_mm_or_si128(S,T)); } while (0 == 1)
+#define ROP_66_CODE(O,D,S,T) do { O = D^S; } while (0)
+#define ROP_66_MM_CODE(O,D,S,T) do { _mm_storeu_si128(O,_mm_xor_si128(_mm_loadu_si128(D),S)); } while (0 == 1)
+
 /* Rop specific code */
 /* Rop 0x55 = Invert   dep=1  (all cases) */
 #ifdef USE_TEMPLATES
@@ -433,6 +463,7 @@ static void xor_rop_run8_const_st(rop_run_op *op, byte *d, int len)
 #define TEMPLATE_NAME          xor_rop_run24_const_st
 #define SPECIFIC_ROP           0x66
 #define SPECIFIC_CODE(O,D,S,T) do { O = D^S; } while (0)
+#define MM_SPECIFIC_CODE       ROP_66_MM_CODE
 #define S_CONST
 #define T_CONST
 #include "gsroprun24.h"
@@ -572,6 +603,152 @@ static void copys_rop_run24(rop_run_op *op, byte *d, int len)
 }
 #endif
 
+/* SSE capable runs for the rops that dominate PCL and PCL-XL jobs. Without
+ * HAVE_SSE2 these are plain specialised loops. */
+#ifdef USE_TEMPLATES
+/* rop = 0xCA = (s & t) | (d & ~t)  dep=8/24  (t selects s over d) */
+#define TEMPLATE_NAME          dst_sel_rop_run8
+#define SPECIFIC_ROP           0xCA
+#define SPECIFIC_CODE          ROP_CA_CODE
+#define MM_SPECIFIC_CODE       ROP_CA_MM_CODE
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          dst_sel_rop_run8_const_t
+#define SPECIFIC_ROP           0xCA
+#define SPECIFIC_CODE          ROP_CA_CODE
+#define MM_SPECIFIC_CODE       ROP_CA_MM_CODE
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          dst_sel_rop_run24
+#define SPECIFIC_ROP           0xCA
+#define SPECIFIC_CODE          ROP_CA_CODE
+#define MM_SPECIFIC_CODE       ROP_CA_MM_CODE
+#include "gsroprun24.h"
+#define TEMPLATE_NAME          dst_sel_rop_run24_const_t
+#define SPECIFIC_ROP           0xCA
+#define SPECIFIC_CODE          ROP_CA_CODE
+#define MM_SPECIFIC_CODE       ROP_CA_MM_CODE
+#define T_CONST
+#include "gsroprun24.h"
+
+/* rop = 0xB8 = (t & ~s) | (d & s)  dep=8/24  (transparent source over t) */
+#define TEMPLATE_NAME          tsel_rop_run8
+#define SPECIFIC_ROP           0xB8
+#define SPECIFIC_CODE          ROP_B8_CODE
+#define MM_SPECIFIC_CODE       ROP_B8_MM_CODE
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          tsel_rop_run8_const_t
+#define SPECIFIC_ROP           0xB8
+#define SPECIFIC_CODE          ROP_B8_CODE
+#define MM_SPECIFIC_CODE       ROP_B8_MM_CODE
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          tsel_rop_run24
+#define SPECIFIC_ROP           0xB8
+#define SPECIFIC_CODE          ROP_B8_CODE
+#define MM_SPECIFIC_CODE       ROP_B8_MM_CODE
+#include "gsroprun24.h"
+#define TEMPLATE_NAME          tsel_rop_run24_const_t
+#define SPECIFIC_ROP           0xB8
+#define SPECIFIC_CODE          ROP_B8_CODE
+#define MM_SPECIFIC_CODE       ROP_B8_MM_CODE
+#define T_CONST
+#include "gsroprun24.h"
+
+/* rop = 0xEE = d | s  dep=8/24 */
+#define TEMPLATE_NAME          dors_rop_run8_const_t
+#define SPECIFIC_ROP           0xEE
+#define SPECIFIC_CODE          ROP_EE_CODE
+#define MM_SPECIFIC_CODE       ROP_EE_MM_CODE
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          dors_rop_run8_const_st
+#define SPECIFIC_ROP           0xEE
+#define SPECIFIC_CODE          ROP_EE_CODE
+#define MM_SPECIFIC_CODE       ROP_EE_MM_CODE
+#define S_CONST
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          dors_rop_run24_const_t
+#define SPECIFIC_ROP           0xEE
+#define SPECIFIC_CODE          ROP_EE_CODE
+#define MM_SPECIFIC_CODE       ROP_EE_MM_CODE
+#define T_CONST
+#include "gsroprun24.h"
+#define TEMPLATE_NAME          dors_rop_run24_const_st
+#define SPECIFIC_ROP           0xEE
+#define SPECIFIC_CODE          ROP_EE_CODE
+#define MM_SPECIFIC_CODE       ROP_EE_MM_CODE
+#define S_CONST
+#define T_CONST
+#include "gsroprun24.h"
+
+/* rop = 0x88 = d & s  dep=8/24  (transparent source) */
+#define TEMPLATE_NAME          dands_rop_run8_const_t
+#define SPECIFIC_ROP           0x88
+#define SPECIFIC_CODE          ROP_88_CODE
+#define MM_SPECIFIC_CODE       ROP_88_MM_CODE
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          dands_rop_run8_const_st
+#define SPECIFIC_ROP           0x88
+#define SPECIFIC_CODE          ROP_88_CODE
+#define MM_SPECIFIC_CODE       ROP_88_MM_CODE
+#define S_CONST
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          dands_rop_run24_const_t
+#define SPECIFIC_ROP           0x88
+#define SPECIFIC_CODE          ROP_88_CODE
+#define MM_SPECIFIC_CODE       ROP_88_MM_CODE
+#define T_CONST
+#include "gsroprun24.h"
+#define TEMPLATE_NAME          dands_rop_run24_const_st
+#define SPECIFIC_ROP           0x88
+#define SPECIFIC_CODE          ROP_88_CODE
+#define MM_SPECIFIC_CODE       ROP_88_MM_CODE
+#define S_CONST
+#define T_CONST
+#include "gsroprun24.h"
+
+/* rop = 0xFC = s | t  dep=8/24 */
+#define TEMPLATE_NAME          sort_rop_run8
+#define SPECIFIC_ROP           0xFC
+#define SPECIFIC_CODE          ROP_FC_CODE
+#define MM_SPECIFIC_CODE       ROP_FC_MM_CODE
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          sort_rop_run8_const_t
+#define SPECIFIC_ROP           0xFC
+#define SPECIFIC_CODE          ROP_FC_CODE
+#define MM_SPECIFIC_CODE       ROP_FC_MM_CODE
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          sort_rop_run24
+#define SPECIFIC_ROP           0xFC
+#define SPECIFIC_CODE          ROP_FC_CODE
+#define MM_SPECIFIC_CODE       ROP_FC_MM_CODE
+#include "gsroprun24.h"
+#define TEMPLATE_NAME          sort_rop_run24_const_t
+#define SPECIFIC_ROP           0xFC
+#define SPECIFIC_CODE          ROP_FC_CODE
+#define MM_SPECIFIC_CODE       ROP_FC_MM_CODE
+#define T_CONST
+#include "gsroprun24.h"
+
+/* rop = 0x66 = d ^ s  dep=8/24  s bitmap */
+#define TEMPLATE_NAME          xor_rop_run8_const_t
+#define SPECIFIC_ROP           0x66
+#define SPECIFIC_CODE          ROP_66_CODE
+#define MM_SPECIFIC_CODE       ROP_66_MM_CODE
+#define T_CONST
+#include "gsroprun8.h"
+#define TEMPLATE_NAME          xor_rop_run24_const_t
+#define SPECIFIC_ROP           0x66
+#define SPECIFIC_CODE          ROP_66_CODE
+#define MM_SPECIFIC_CODE       ROP_66_MM_CODE
+#define T_CONST
+#include "gsroprun24.h"
+#endif /* USE_TEMPLATES */
+
 /* Generic ROP run code */
 #ifdef USE_TEMPLATES
 #define TEMPLATE_NAME          generic_rop_run1
@@ -1390,6 +1567,80 @@ retry:
     case ROP_SPECIFIC_KEY(0xEE, 1, rop_t_constant):
         op->run     = dors_rop_run1_const_t;
         break;
+#ifdef USE_TEMPLATES
+    /* 0xCA = (S & T) | (D & ~T) */
+    case ROP_SPECIFIC_KEY(0xCA, 8, 0):
+        op->run     = dst_sel_rop_run8;
+        break;
+    case ROP_SPECIFIC_KEY(0xCA, 8, rop_t_constant):
+        op->run     = dst_sel_rop_run8_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0xCA, 24, 0):
+        op->run     = dst_sel_rop_run24;
+        break;
+    case ROP_SPECIFIC_KEY(0xCA, 24, rop_t_constant):
+        op->run     = dst_sel_rop_run24_const_t;
+        break;
+    /* 0xB8 = (T & ~S) | (D & S) */
+    case ROP_SPECIFIC_KEY(0xB8, 8, 0):
+        op->run     = tsel_rop_run8;
+        break;
+    case ROP_SPECIFIC_KEY(0xB8, 8, rop_t_constant):
+        op->run     = tsel_rop_run8_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0xB8, 24, 0):
+        op->run     = tsel_rop_run24;
+        break;
+    case ROP_SPECIFIC_KEY(0xB8, 24, rop_t_constant):
+        op->run     = tsel_rop_run24_const_t;
+        break;
+    /* 0xEE = D | S */
+    case ROP_SPECIFIC_KEY(0xEE, 8, rop_t_constant): /* T_UNUSED */
+        op->run     = dors_rop_run8_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0xEE, 8, rop_s_constant | rop_t_constant): /* T_UNUSED */
+        op->run     = dors_rop_run8_const_st;
+        break;
+    case ROP_SPECIFIC_KEY(0xEE, 24, rop_t_constant): /* T_UNUSED */
+        op->run     = dors_rop_run24_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0xEE, 24, rop_s_constant | rop_t_constant): /* T_UNUSED */
+        op->run     = dors_rop_run24_const_st;
+        break;
+    /* 0x88 = D & S */
+    case ROP_SPECIFIC_KEY(0x88, 8, rop_t_constant): /* T_UNUSED */
+        op->run     = dands_rop_run8_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0x88, 8, rop_s_constant | rop_t_constant): /* T_UNUSED */
+        op->run     = dands_rop_run8_const_st;
+        break;
+    case ROP_SPECIFIC_KEY(0x88, 24, rop_t_constant): /* T_UNUSED */
+        op->run     = dands_rop_run24_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0x88, 24, rop_s_constant | rop_t_constant): /* T_UNUSED */
+        op->run     = dands_rop_run24_const_st;
+        break;
+    /* 0xFC = S | T */
+    case ROP_SPECIFIC_KEY(0xFC, 8, 0): /* D_UNUSED */
+        op->run     = sort_rop_run8;
+        break;
+    case ROP_SPECIFIC_KEY(0xFC, 8, rop_t_constant): /* D_UNUSED */
+        op->run     = sort_rop_run8_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0xFC, 24, 0): /* D_UNUSED */
+        op->run     = sort_rop_run24;
+        break;
+    case ROP_SPECIFIC_KEY(0xFC, 24, rop_t_constant): /* D_UNUSED */
+        op->run     = sort_rop_run24_const_t;
+        break;
+    /* 0x66 = D ^ S, S bitmap */
+    case ROP_SPECIFIC_KEY(0x66, 8, rop_t_constant): /* T_UNUSED */
+        op->run     = xor_rop_run8_const_t;
+        break;
+    case ROP_SPECIFIC_KEY(0x66, 24, rop_t_constant): /* T_UNUSED */
+        op->run     = xor_rop_run24_const_t;
+        break;
+#endif /* USE_TEMPLATES */
     /* Then the generic ones */
     case KEY(1, 0):
         op->run     = generic_rop_run1;
@@ -39,9 +39,20 @@
  *                               being a pointer to a 1 bit bitmap to choose
  *                               between scolors[0] and [1]. If set to 1, the
  *                               code will assume that this is the case.
+ *
+ * To make use of SSE here, you must also define:
+ *
+ * MM_SPECIFIC_CODE             If set, SSE can be used. Will be invoked as
+ *                              MM_SPECIFIC_CODE(OUT_PTR,D_PTR,S,T), 3 times
+ *                              for every 16 pixels. Note: SPECIFIC_ROP must
+ *                              be set, and neither S_1BIT nor T_1BIT may be.
  */
 
 #if defined(TEMPLATE_NAME)
+/* Can't do MM_SPECIFIC_CODE if we don't HAVE_SSE2, or on 1 bit data */
+#if !defined(HAVE_SSE2) || defined(S_1BIT) || defined(T_1BIT)
+#undef MM_SPECIFIC_CODE
+#endif
 
 #ifdef SPECIFIC_ROP
 #if rop3_uses_S(SPECIFIC_ROP)
@@ -71,14 +82,24 @@
 
 #if defined(S_USED) && !defined(S_CONST)
 #define FETCH_S      do { S = GET24(s); s += 3; } while (0==1)
+#define MM_FETCH_S   do { MM_S[0] = _mm_loadu_si128((__m128i const *)s);\
+                          MM_S[1] = _mm_loadu_si128((__m128i const *)(s+16));\
+                          MM_S[2] = _mm_loadu_si128((__m128i const *)(s+32));\
+                          s += 48; } while (0==1)
 #else /* !defined(S_USED) || defined(S_CONST) */
 #define FETCH_S
+#define MM_FETCH_S
 #endif /* !defined(S_USED) || defined(S_CONST) */
 
 #if defined(T_USED) && !defined(T_CONST)
 #define FETCH_T      do { T = GET24(t); t += 3; } while (0 == 1)
+#define MM_FETCH_T   do { MM_T[0] = _mm_loadu_si128((__m128i const *)t);\
+                          MM_T[1] = _mm_loadu_si128((__m128i const *)(t+16));\
+                          MM_T[2] = _mm_loadu_si128((__m128i const *)(t+32));\
+                          t += 48; } while (0 == 1)
 #else /* !defined(T_USED) || defined(T_CONST) */
 #define FETCH_T
+#define MM_FETCH_T
 #endif /* !defined(T_USED) || defined(T_CONST) */
 
 static void TEMPLATE_NAME(rop_run_op *op, byte *d, int len)
@@ -90,6 +111,9 @@ static void TEMPLATE_NAME(rop_run_op *op, byte *d, int len)
 #ifdef S_USED
 #ifdef S_CONST
     rop_operand  S = op->s.c;
+#ifdef MM_SPECIFIC_CODE
+    __m128i      MM_S[3];
+#endif
 #else /* !defined(S_CONST) */
     const byte  *s = op->s.b.ptr;
 #endif /* !defined(S_CONST) */
@@ -104,6 +128,9 @@ static void TEMPLATE_NAME(rop_run_op *op, byte *d, int len)
 #ifdef T_USED
 #ifdef T_CONST
     rop_operand  T = op->t.c;
+#ifdef MM_SPECIFIC_CODE
+    __m128i      MM_T[3];
+#endif
 #else /* !defined(T_CONST) */
     const byte  *t = op->t.b.ptr;
 #endif /* !defined(T_CONST) */
@@ -142,6 +169,35 @@ static void TEMPLATE_NAME(rop_run_op *op, byte *d, int len)
         troll = 0;
 #endif /* T_1BIT == MAYBE */
 #endif /* defined(T_1BIT) */
+
+    /* SSE version. 16 pixels are 3 whole vectors. */
+#ifdef MM_SPECIFIC_CODE
+    if (len > 16) {
+#if defined(S_USED) && defined(S_CONST)
+        rop_splat24(MM_S, S);
+#endif /* defined(S_USED) && defined(S_CONST) */
+#if defined(T_USED) && defined(T_CONST)
+        rop_splat24(MM_T, T);
+#endif /* defined(T_USED) && defined(T_CONST) */
+        do {
+#if defined(S_USED) && !defined(S_CONST)
+            __m128i MM_S[3];
+#endif /* defined(S_USED) && !defined(S_CONST) */
+#if defined(T_USED) && !defined(T_CONST)
+            __m128i MM_T[3];
+#endif /* defined(T_USED) && !defined(T_CONST) */
+            MM_FETCH_S;
+            MM_FETCH_T;
+            MM_SPECIFIC_CODE(((__m128i *)d), ((const __m128i *)d), MM_S[0], MM_T[0]);
+            MM_SPECIFIC_CODE(((__m128i *)(d+16)), ((const __m128i *)(d+16)), MM_S[1], MM_T[1]);
+            MM_SPECIFIC_CODE(((__m128i *)(d+32)), ((const __m128i *)(d+32)), MM_S[2], MM_T[2]);
+            d += 48;
+            len -= 16;
+        } while (len > 16);
+    }
+#endif
+
+    /* Non SSE loop */
     do {
 #if defined(S_USED) && !defined(S_CONST)
         rop_operand S;
@@ -201,6 +257,9 @@ static void TEMPLATE_NAME(rop_run_op *op, byte *d, int len)
 #undef PUT24
 #undef FETCH_S
 #undef FETCH_T
+#undef MM_FETCH_S
+#undef MM_FETCH_T
+#undef MM_SPECIFIC_CODE
 #undef S
 #undef S_1BIT
 #undef S_USED
@@ -3342,6 +3342,7 @@ do_compose_group(pdf14_buf *tos, pdf14_buf *nos, pdf14_buf *maskbuf,
     if ((tos->n_chan == 0) || (nos->n_chan == 0))
         return;
     rect_merge(nos->dirty, tos->dirty);
+    pdf14_buf_mark_dirty(nos, x0, y0, x1 - x0, y1 - y0);
     if (nos->has_tags)
         if_debug7m('v', memory,
                    "pdf14_pop_transparency_group y0 = %d, y1 = %d, w = %d, alpha = %d, shape = %d, tag = %d, bm = %d\n",
@@ -4115,6 +4116,7 @@ do_compose_group16(pdf14_buf *tos, pdf14_buf *nos, pdf14_buf *maskbuf,
     if ((tos->n_chan == 0) || (nos->n_chan == 0))
         return;
     rect_merge(nos->dirty, tos->dirty);
+    pdf14_buf_mark_dirty(nos, x0, y0, x1 - x0, y1 - y0);
     if (nos->has_tags)
         if_debug7m('v', memory,
                    "pdf14_pop_transparency_group y0 = %d, y1 = %d, w = %d, alpha = %d, shape = %d, tag = %d, bm = %d\n",
@@ -4329,6 +4331,7 @@ do_compose_alphaless_group(pdf14_buf *tos, pdf14_buf *nos,
     if ((tos->n_chan == 0) || (nos->n_chan == 0))
         return;
     rect_merge(nos->dirty, tos->dirty);
+    pdf14_buf_mark_dirty(nos, x0, y0, x1 - x0, y1 - y0);
     if (nos->has_tags)
         if_debug7m('v', memory,
                    "pdf14_pop_transparency_group y0 = %d, y1 = %d, w = %d, alpha = %d, shape = %d, tag = %d, bm = %d\n",
@@ -4466,6 +4469,7 @@ do_compose_alphaless_group16(pdf14_buf *tos, pdf14_buf *nos,
     if ((tos->n_chan == 0) || (nos->n_chan == 0))
         return;
     rect_merge(nos->dirty, tos->dirty);
+    pdf14_buf_mark_dirty(nos, x0, y0, x1 - x0, y1 - y0);
     if (nos->has_tags)
         if_debug7m('v', memory,
                    "pdf14_pop_transparency_group y0 = %d, y1 = %d, w = %d, alpha = %d, shape = %d, tag = %d, bm = %d\n",
@@ -5109,10 +5113,7 @@ do_mark_fill_rectangle(gx_device * dev, int x, int y, int w, int h,
     if (x + w > buf->rect.q.x) w = buf->rect.q.x - x;
     if (y + h > buf->rect.q.y) h = buf->rect.q.y - y;
     /* Update the dirty rectangle with the mark */
-    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
-    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
-    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
-    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+    pdf14_buf_mark_dirty(buf, x, y, w, h);
     dst_ptr = buf->data + (x - buf->rect.p.x) + (y - buf->rect.p.y) * rowstride;
     src_alpha = 255-src_alpha;
     shape = 255-shape;
@@ -5750,10 +5751,7 @@ do_mark_fill_rectangle16(gx_device * dev, int x, int y, int w, int h,
     if (x + w > buf->rect.q.x) w = buf->rect.q.x - x;
     if (y + h > buf->rect.q.y) h = buf->rect.q.y - y;
     /* Update the dirty rectangle with the mark */
-    if (x < buf->dirty.p.x) buf->dirty.p.x = x;
-    if (y < buf->dirty.p.y) buf->dirty.p.y = y;
-    if (x + w > buf->dirty.q.x) buf->dirty.q.x = x + w;
-    if (y + h > buf->dirty.q.y) buf->dirty.q.y = y + h;
+    pdf14_buf_mark_dirty(buf, x, y, w, h);
     dst_ptr = (uint16_t *)(buf->data + (x - buf->rect.p.x) * 2 + (y - buf->rect.p.y) * rowstride);
     src_alpha = 65535-src_alpha;
     shape = 65535-shape;
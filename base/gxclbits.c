@@ -35,7 +35,7 @@
  *         bands on a page;
  *      max_ushort to never write in all bands.
  */
-#define CHAR_ALL_BANDS_COUNT max_ushort
+#define CHAR_ALL_BANDS_COUNT 4
 
 /* ------ Writing ------ */
 
@@ -440,6 +440,63 @@ clist_find_bits(gx_device_clist_writer * cldev, gx_bitmap_id id, tile_loc * ploc
     return false;
 }
 
+/* Look up a tile or character by id, or by an id that we have found to */
+/* have the same bits as a cached one. */
+static bool
+clist_find_tile(gx_device_clist_writer * cldev, gx_bitmap_id id, tile_loc * ploc)
+{
+    const tile_alias *alias;
+
+    if (clist_find_bits(cldev, id, ploc))
+        return true;
+    alias = &cldev->tile_alias_table[tile_id_hash(id) & cldev->tile_hash_mask];
+    return alias->alias == id && clist_find_bits(cldev, alias->id, ploc);
+}
+
+/* Hash the bits of a tile, as clist_add_tile would store them. */
+static uint
+clist_tile_content_hash(const gx_strip_bitmap * tiles, uint sraster,
+                        int depth)
+{
+    int pdepth = depth / tiles->num_planes;
+    uint width_bytes = (tiles->rep_width * pdepth + 7) >> 3;
+    uint height = tiles->rep_height * tiles->num_planes;
+    const byte *row = tiles->data;
+    uint hash = ((tiles->rep_width * 31 + tiles->rep_height) * 31 +
+                 tiles->rep_shift) * 31 + depth;
+    uint x, y;
+
+    for (y = 0; y < height; y++, row += sraster)
+        for (x = 0; x < width_bytes; x++)
+            hash = hash * 31 + row[x];
+    return hash;
+}
+
+/* Check whether a cached tile has exactly the bits and shape of a tile */
+/* that clist_add_tile would make. */
+static bool
+clist_tile_bits_match(const gx_device_clist_writer * cldev,
+                      const tile_slot * slot, const gx_strip_bitmap * tiles,
+                      uint sraster, int depth)
+{
+    int pdepth = depth / tiles->num_planes;
+    uint width_bytes = (tiles->rep_width * pdepth + 7) >> 3;
+    uint height = tiles->rep_height * tiles->num_planes;
+    const byte *row = tiles->data;
+    const byte *bits = ts_bits(cldev, slot);
+    uint y;
+
+    if (slot->head.depth != depth || slot->raster != tiles->raster ||
+        slot->width != tiles->rep_width || slot->height != tiles->rep_height ||
+        slot->shift != tiles->rep_shift ||
+        slot->num_planes != tiles->num_planes)
+        return false;
+    for (y = 0; y < height; y++, row += sraster, bits += slot->raster)
+        if (memcmp(bits, row, width_bytes))
+            return false;
+    return true;
+}
+
 /* Delete a tile from the cache. */
 static void
 clist_delete_tile(gx_device_clist_writer * cldev, tile_slot * slot)
@@ -488,7 +545,24 @@ clist_add_tile(gx_device_clist_writer * cldev, const gx_strip_bitmap * tiles,
     uint tsize =
     sizeof(tile_slot) + cldev->tile_band_mask_size + size_bytes;
     tile_slot *slot;
+    gx_bitmap_id *pcontent = &cldev->tile_content_table[
+        clist_tile_content_hash(tiles, sraster, depth) & cldev->tile_hash_mask];
+    tile_loc loc;
+
+    /* If we already have these bits under another id, use those. */
+    if (*pcontent != gx_no_bitmap_id &&
+        clist_find_bits(cldev, *pcontent, &loc) &&
+        clist_tile_bits_match(cldev, loc.tile, tiles, sraster, depth)
+        ) {
+        tile_alias *alias = &cldev->tile_alias_table[
+            tile_id_hash(tiles->id) & cldev->tile_hash_mask];
 
+        if_debug2m('L', cldev->memory, "[L]aliasing id=0x%lx to id=0x%lx\n",
+                   (ulong) tiles->id, (ulong) *pcontent);
+        alias->alias = tiles->id;
+        alias->id = *pcontent;
+        return 0;
+    }
     if (cldev->bits.csize == cldev->tile_max_count) {	/* Don't let the hash table get too full: delete an entry. */
         /* Since gx_bits_cache_alloc returns an entry to delete when */
         /* it fails, just force it to fail. */
@@ -536,22 +610,19 @@ clist_add_tile(gx_device_clist_writer * cldev, const gx_strip_bitmap * tiles,
                                       (tiles->rep_width * depth + 7) >> 3,
                                       tiles->rep_height * slot->num_planes);
     /* Make the hash table entry. */
-    {
-        tile_loc loc;
-
 #ifdef DEBUG
-        if (clist_find_bits(cldev, tiles->id, &loc))
-            lprintf1("clist_find_bits(0x%lx) should have failed!\n",
-                     (ulong) tiles->id);
+    if (clist_find_bits(cldev, tiles->id, &loc))
+        lprintf1("clist_find_bits(0x%lx) should have failed!\n",
+                 (ulong) tiles->id);
 #else
-        clist_find_bits(cldev, tiles->id, &loc);	/* always fails */
+    clist_find_bits(cldev, tiles->id, &loc);	/* always fails */
 #endif
-        slot->index = loc.index;
-        cldev->tile_table[loc.index].offset =
-            (byte *) slot - cldev->data;
-        if_debug2m('L', cldev->memory, "[L]adding index=%u, offset=%lu\n",
-                   loc.index, cldev->tile_table[loc.index].offset);
-    }
+    slot->index = loc.index;
+    cldev->tile_table[loc.index].offset =
+        (byte *) slot - cldev->data;
+    if_debug2m('L', cldev->memory, "[L]adding index=%u, offset=%lu\n",
+               loc.index, cldev->tile_table[loc.index].offset);
+    *pcontent = tiles->id;
     slot->num_bands = 0;
     return 0;
 }
@@ -635,7 +706,7 @@ clist_change_tile(gx_device_clist_writer * cldev, gx_clist_state * pcls,
    (tiles)->rep_shift != (cldev)->tile_params.rep_shift ||\
    (depth) != (cldev)->tile_depth)
 
-  top:if (clist_find_bits(cldev, tiles->id, &loc)) {	/* The bitmap is in the cache.  Check whether this band */
+  top:if (clist_find_tile(cldev, tiles->id, &loc)) {	/* The bitmap is in the cache.  Check whether this band */
         /* knows about it. */
         int band_index = pcls - cldev->states;
         byte *bptr = ts_mask(loc.tile) + (band_index >> 3);
@@ -769,7 +840,7 @@ clist_change_bits(gx_device_clist_writer * cldev, gx_clist_state * pcls,
     byte bmask = 1 << (band_index & 7);
     byte *bptr;
 
-    while (!clist_find_bits(cldev, tiles->id, &loc)) {
+    while (!clist_find_tile(cldev, tiles->id, &loc)) {
         /* The tile is not in the cache. */
         code = clist_add_tile(cldev, tiles, tiles->raster, depth);
         if (code < 0)
@@ -828,9 +899,17 @@ clist_change_bits(gx_device_clist_writer * cldev, gx_clist_state * pcls,
         if_debug7m('L', cldev->memory, " compress=%d depth=%d size=(%d,%d) planes=%d index=%d offset=%ld\n",
                    code, depth, loc.tile->width, loc.tile->height, loc.tile->num_planes, loc.index, offset);
         if (bit_pcls == NULL) {
+            int band;
+
             memset(ts_mask(loc.tile), 0xff,
                    cldev->tile_band_mask_size);
             loc.tile->num_bands = cldev->nbands;
+            /* Reading the bits makes this the current tile in every */
+            /* band, so every band has to know that. */
+            for (band = 0; band < cldev->nbands; band++) {
+                cldev->states[band].tile_index = loc.index;
+                cldev->states[band].tile_id = loc.tile->id;
+            }
         } else {
             *bptr |= bmask;
             loc.tile->num_bands++;
@@ -868,6 +868,10 @@ int clist_playback_file_bands(clist_playback_action action,
                           gx_device_clist_reader *crdev,
                           gx_band_page_info_t *page_info, gx_device *target,
                           int band_first, int band_last, int x0, int y0);
+
+/* Read a pseudo-band chunk from the cfile that a band stream is reading. */
+int clist_read_band_stream_chunk(const stream_state *st, int64_t position,
+                                 int size, byte *buf);
 #ifdef DEBUG
 int64_t clist_file_offset(const stream_state *st, uint buffer_offset);
 void top_up_offset_map(stream_state * st, const byte *buf, const byte *ptr, const byte *end);
@@ -896,7 +900,8 @@ int cmd_write_icctable(gx_device_clist_writer * cldev, unsigned char *pbuf, int
 typedef enum {
     COLOR_USAGE_OFFSET = 1,
     SPOT_EQUIV_COLORS = 2,
-    ICC_TABLE_OFFSET = 3
+    ICC_TABLE_OFFSET = 3,
+    SHARED_PATH_OFFSET = 4
 
 } psuedoband_offset;
 
@@ -35,6 +35,10 @@
 #define CL_CACHE_SLOT_SIZE_LOG2 (15)
 #define CL_CACHE_SLOT_EMPTY (-1)
 
+/* Writes are gathered into a buffer and issued as single aligned writes, */
+/* rather than one pwrite per command block. */
+#define CL_WRITE_BUFFER_SIZE_LOG2 (18)
+
 static clist_io_procs_t clist_io_procs_file;
 
 typedef struct
@@ -229,6 +233,10 @@ typedef struct
     int64_t pos;
     int64_t filesize;		/* filesize maintained by clist_fwrite */
     CL_CACHE *cache;
+    byte *wbuf;			/* pending writes, allocated on first write */
+    int64_t wbuf_pos;		/* file position of wbuf[0] */
+    uint wbuf_len;		/* number of pending bytes in wbuf */
+    bool wbuf_error;		/* a deferred write failed */
 } IFILE;
 
 static void
@@ -262,17 +270,43 @@ static IFILE *wrap_file(gs_memory_t *mem, gp_file *f, const char *fmode)
     ifile->pos = 0;
     ifile->filesize = 0;
     ifile->cache = cl_cache_alloc(ifile->mem);
+    ifile->wbuf = NULL;
+    ifile->wbuf_pos = 0;
+    ifile->wbuf_len = 0;
+    ifile->wbuf_error = false;
     return ifile;
 }
 
+/* Issue any writes gathered in the write buffer. */
+static int
+clist_flush_writes(IFILE *ifile)
+{
+    int res;
+
+    if (ifile->wbuf_len == 0)
+        return 0;
+    res = gp_fpwrite((char *)ifile->wbuf, ifile->wbuf_len, ifile->wbuf_pos, ifile->f);
+    if (res != (int)ifile->wbuf_len) {
+        ifile->wbuf_len = 0;
+        ifile->wbuf_error = true;
+        return_error(gs_error_ioerror);
+    }
+    ifile->wbuf_len = 0;
+    return 0;
+}
+
 static int clist_close_file(IFILE *ifile)
 {
     int res = 0;
     if (ifile) {
-        if (ifile->f != NULL)
-            res = gp_fclose(ifile->f);
+        if (clist_flush_writes(ifile) < 0)
+            res = -1;
+        if (ifile->f != NULL && gp_fclose(ifile->f) != 0)
+            res = -1;
         if (ifile->cache != NULL)
             cl_cache_destroy(ifile->cache);
+        if (ifile->wbuf != NULL)
+            gs_free_object(ifile->mem, ifile->wbuf, "Free IFILE write buffer");
         gs_free_object(ifile->mem, ifile, "Free wrapped IFILE");
     }
     return res;
@@ -305,6 +339,10 @@ clist_fopen(char fname[gp_file_name_sizeof], const char *fmode,
         clist_file_ptr ocf = fake_path_to_file(fname);
         if (ocf) {
             /*  A special (fake) fname is passed in. If so, clone the FILE handle */
+            /* The clone reads through its own descriptor, so it must see */
+            /* everything written so far. */
+            if (clist_flush_writes((IFILE *)ocf) < 0)
+                return_error(gs_error_ioerror);
             *pcf = wrap_file(mem, gp_fdup(((IFILE *)ocf)->f, fmode), fmode);
             /* when cloning, copy other parts not done by wrap_file */
             if (*pcf)
@@ -344,7 +382,9 @@ clist_fclose(clist_file_ptr cf, const char *fname, bool delete)
         /* fname is an encoded file pointer, and cf is the FILE used to create it.
          * We shouldn't close it unless we have been asked to delete it, in which
          * case closing it will delete it */
-        return delete ? (clist_close_file((IFILE *)ocf) ? gs_note_error(gs_error_ioerror) : 0) : 0;
+        if (delete)
+            return clist_close_file((IFILE *)ocf) ? gs_note_error(gs_error_ioerror) : 0;
+        return clist_flush_writes((IFILE *)ocf);
     } else {
         return (clist_close_file((IFILE *) cf) != 0 ? gs_note_error(gs_error_ioerror) :
                 delete ? clist_unlink(fname) :
@@ -361,7 +401,41 @@ clist_fwrite_chars(const void *data, uint len, clist_file_ptr cf)
     IFILE *icf = (IFILE *)cf;
 
     if (gp_can_share_fdesc()) {
-        res = gp_fpwrite((char *)data, len, ((IFILE *)cf)->pos, ((IFILE *)cf)->f);
+        const uint wbuf_size = 1 << CL_WRITE_BUFFER_SIZE_LOG2;
+
+        if (icf->wbuf == NULL && len < wbuf_size)
+            icf->wbuf = gs_alloc_bytes(icf->mem, wbuf_size, "IFILE write buffer");
+        /* Pending data must be contiguous with this write. */
+        if (icf->wbuf_len != 0 && icf->wbuf_pos + icf->wbuf_len != icf->pos)
+            res = clist_flush_writes(icf);
+        if (icf->wbuf == NULL || len >= wbuf_size) {
+            if (res >= 0)
+                res = clist_flush_writes(icf);
+            if (res >= 0)
+                res = gp_fpwrite((char *)data, len, icf->pos, icf->f);
+        } else if (res >= 0) {
+            const byte *dp = data;
+            uint left = len;
+
+            /* Fill the buffer up to the next aligned file offset, so */
+            /* that the flushed writes fall on block boundaries. */
+            while (left > 0 && res >= 0) {
+                uint room, n;
+
+                if (icf->wbuf_len == 0)
+                    icf->wbuf_pos = icf->pos + (len - left);
+                room = wbuf_size - (uint)((icf->wbuf_pos + icf->wbuf_len) & (wbuf_size - 1));
+                n = min(room, left);
+                memcpy(icf->wbuf + icf->wbuf_len, dp, n);
+                icf->wbuf_len += n;
+                dp += n;
+                left -= n;
+                if (n == room)
+                    res = clist_flush_writes(icf);
+            }
+            if (res >= 0)
+                res = len;
+        }
     } else {
         res = gp_fwrite(data, 1, len, ((IFILE *)cf)->f);
     }
@@ -387,6 +461,9 @@ clist_fread_chars(void *data, uint len, clist_file_ptr cf)
         IFILE *icf = (IFILE *)cf;
         byte *dp = data;
 
+        if (clist_flush_writes(icf) < 0)
+            return -1;
+
         /* if we have a cache, check if it needs init, and do it */
         if (CL_CACHE_NEEDS_INIT(icf->cache)) {
             icf->cache = cl_cache_read_init(icf->cache, CL_CACHE_NSLOTS, 1<<CL_CACHE_SLOT_SIZE_LOG2, icf->filesize);
@@ -458,7 +535,7 @@ clist_set_memory_warning(clist_file_ptr cf, int bytes_left)
 static int
 clist_ferror_code(clist_file_ptr cf)
 {
-    return (gp_ferror(((IFILE *)cf)->f) ? gs_error_ioerror : 0);
+    return (((IFILE *)cf)->wbuf_error || gp_ferror(((IFILE *)cf)->f) ? gs_error_ioerror : 0);
 }
 
 static int64_t
@@ -484,6 +561,8 @@ clist_rewind(clist_file_ptr cf, bool discard_data, const char *fname)
              * new scratch file. */
             char tfname[gp_file_name_sizeof] = {0};
             const gs_memory_t *mem = ocf->f->memory;
+            ocf->wbuf_len = 0;	/* pending writes are discarded with the file */
+            ocf->wbuf_error = false;
             gp_fclose(ocf->f);
             ocf->f = gp_open_scratch_file_rm(mem, gp_scratch_file_name_prefix, tfname, fmode);
             if (ocf->f == NULL)
@@ -497,6 +576,11 @@ clist_rewind(clist_file_ptr cf, bool discard_data, const char *fname)
                     return_error(gs_error_ioerror);
             }
             ((IFILE *)cf)->filesize = 0;
+        } else {
+            int code = clist_flush_writes((IFILE *)cf);
+
+            if (code < 0)
+                return code;
         }
         ((IFILE *)cf)->pos = 0;
     } else {
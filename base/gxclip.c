@@ -130,6 +130,7 @@ gx_make_clip_device_on_stack(gx_device_clip * dev, const gx_clip_path *pcpath, g
 {
     gx_device_init_on_stack((gx_device *)dev, (const gx_device *)&gs_clip_device, target->memory);
     dev->cpath = pcpath;
+    gx_cpath_index_list(pcpath);
     dev->list = *gx_cpath_list(pcpath);
     /* NOTE we do not count up the rect list even though we've taken a reference to it.
      * this is because we would then need to count it down in gx_destroy_clip_device_on_stack
@@ -181,6 +182,7 @@ gx_make_clip_device_on_stack_if_needed(gx_device_clip * dev, const gx_clip_path
         return target;
     }
     gx_device_init_on_stack((gx_device *)dev, (const gx_device *)&gs_clip_device, target->memory);
+    gx_cpath_index_list(pcpath);
     dev->list = *gx_cpath_list(pcpath);
     dev->translation.x = 0;
     dev->translation.y = 0;
@@ -206,6 +208,7 @@ gx_make_clip_device_in_heap(gx_device_clip *dev,
     /* Can never fail */
     (void)gx_device_init((gx_device *)dev,
                          (const gx_device *)&gs_clip_device, mem, true);
+    gx_cpath_index_list(pcpath);
     dev->list = *gx_cpath_list(pcpath);
     dev->rect_list = pcpath->rect_list;
     /* Bug #706771 we must make sure that the clip rectangle list does not
@@ -246,6 +249,38 @@ static const uint clip_interval = 10000;
 # define INCR_THEN(v, e) (e)
 #endif
 
+/*
+ * If the list has a row index and y is not in or next to the cursor's row,
+ * binary search the index for the first rectangle with y < ymax.  This
+ * leaves rptr where the warp loops below would have put it, so they then
+ * have nothing left to do.  The last entry of the index is the tail stopper,
+ * whose ymax is max_int, so the search always finds a row.
+ */
+static inline gx_clip_rect *
+clip_list_seek(const gx_clip_list *list, gx_clip_rect *rptr, int y)
+{
+    int lo, hi;
+
+    if (list->index == 0)
+        return rptr;
+    if (y >= rptr->ymax) {
+        if (rptr->next == 0 || y < rptr->next->ymax)
+            return rptr;
+    } else if (rptr->prev == 0 || y >= rptr->prev->ymax)
+        return rptr;
+    lo = 0;
+    hi = list->index_count - 1;
+    while (lo < hi) {
+        int mid = (lo + hi) >> 1;
+
+        if (y < list->index[mid]->ymax)
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
+    return list->index[lo];
+}
+
 /*
  * Enumerate the rectangles of the x,w,y,h argument that fall within
  * the clipping region.
@@ -287,6 +322,7 @@ clip_enumerate_rest(gx_device_clip * rdev,
      * is more than one rectangle, there is a 'stopper' at the end of
      * the list.
      */
+    rptr = clip_list_seek(&rdev->list, rptr, y);
     if (y >= rptr->ymax) {
         /* Bug 706875: The 'stopper' here is a rectangle from (max_int, max_int) to
          * (max_int, max_int). Hence it doesn't 'stop' cases when y == max_int.
@@ -1511,6 +1547,7 @@ static int clip_list_enumerate_intersections(gx_clip_list *list, int (*process)(
      * is more than one rectangle, there is a 'stopper' at the end of
      * the list.
      */
+    rptr = clip_list_seek(list, rptr, y);
     if (y >= rptr->ymax) {
         /* Bug 706875: The 'stopper' here is a rectangle from (max_int, max_int) to
          * (max_int, max_int). Hence it doesn't 'stop' cases when y == max_int.
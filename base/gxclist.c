@@ -235,7 +235,8 @@ clist_tile_cache_size(const gx_device * target, size_t data_size)
 
 /*
  * Initialize the allocation for the tile cache.  Sets: tile_hash_mask,
- * tile_max_count, tile_table, chunk (structure), bits (structure).
+ * tile_max_count, tile_table, tile_content_table, tile_alias_table,
+ * chunk (structure), bits (structure).
  */
 static int
 clist_init_tile_cache(gx_device * dev, byte * init_data, size_t data_size)
@@ -266,13 +267,17 @@ clist_init_tile_cache(gx_device * dev, byte * init_data, size_t data_size)
     else if (hc > 0xfff)
         hc = 0xfff;             /* cmd_op_set_tile_index has 12-bit operand */
     /* Make sure the tables will fit. */
-    while (hc >= 3 && (hsize = (hc + 1) * sizeof(tile_hash)) >= bits_size)
+    while (hc >= 3 && (hsize = (hc + 1) * (sizeof(tile_hash) +
+                                          sizeof(gx_bitmap_id) +
+                                          sizeof(tile_alias))) >= bits_size)
         hc >>= 1;
     if (hc < 3)
         return_error(gs_error_rangecheck);
     cdev->tile_hash_mask = hc;
     cdev->tile_max_count = hc - (hc >> 2);
     cdev->tile_table = (tile_hash *) data;
+    cdev->tile_alias_table = (tile_alias *)(cdev->tile_table + hc + 1);
+    cdev->tile_content_table = (gx_bitmap_id *)(cdev->tile_alias_table + hc + 1);
     data += hsize;
     bits_size -= hsize;
     gx_bits_cache_chunk_init(cdev->cache_chunk, data, bits_size);
@@ -512,6 +517,10 @@ clist_reset(gx_device * dev)
     cdev->ymin = cdev->ymax = -1;       /* render_init not done yet */
     memset(cdev->tile_table, 0, (cdev->tile_hash_mask + 1) *
        sizeof(*cdev->tile_table));
+    memset(cdev->tile_alias_table, 0, (cdev->tile_hash_mask + 1) *
+       sizeof(*cdev->tile_alias_table));
+    memset(cdev->tile_content_table, 0, (cdev->tile_hash_mask + 1) *
+       sizeof(*cdev->tile_content_table));
     cdev->cnext = cdev->cbuf;
     cdev->ccl = 0;
     cdev->band_range_list->head = cdev->band_range_list->tail = 0;
@@ -128,6 +128,18 @@ typedef struct {
     /* reading: offset from cdev->chunk.data */
 } tile_hash;
 
+/*
+ * When writing, a tile whose id isn't in the cache may still have the
+ * same bits as one that is (a character re-rendered after the font cache
+ * was purged, an image mask drawn again and again). We find such tiles
+ * by hashing their bits, and remember the new id as an alias of the
+ * cached one, so that the bits are only stored and written once.
+ */
+typedef struct {
+    gx_bitmap_id alias;		/* id we were given */
+    gx_bitmap_id id;		/* id of the cached tile with the same bits */
+} tile_alias;
+
 typedef struct {
     gx_cached_bits_common;
     /* To save space, instead of storing rep_width and rep_height, */
@@ -316,6 +328,9 @@ struct gx_device_clist_writer_s {
     int band_range_min, band_range_max;		/* range for list */
     uint tile_max_size;		/* max size of a single tile (bytes) */
     uint tile_max_count;	/* max # of hash table entries */
+    gx_bitmap_id *tile_content_table;	/* ids of cached tiles, indexed */
+                                /* by hash of their bits */
+    tile_alias *tile_alias_table;	/* indexed by hash of alias id */
     gx_strip_bitmap tile_params;	/* current tile parameters */
     int tile_depth;		/* current tile depth */
     int tile_known_min, tile_known_max;  /* range of bands that knows the */
@@ -400,6 +415,7 @@ typedef struct gx_device_clist_reader_s {
     int curr_render_thread;		/* index into array */
     int thread_lookahead_direction;	/* +1 or -1 */
     int next_band;			/* may be < 0 or >= num bands when no more remain to render */
+    struct clist_compose_budget_s *compose_budget; /* threads pdf14 may borrow, or NULL */
 
 } gx_device_clist_reader;
 
@@ -41,11 +41,35 @@
 ulong stats_cmd_diffs[5];
 #endif
 
+/*
+ * A path that would be written, unchanged, into many bands is instead
+ * written once into a pseudo-band record of the cfile, and each band gets
+ * a cmd_opv_ext_shared_path command giving the record's position and size.
+ * The segments are relative to (0,0) rather than to the band's current
+ * point; 'end' is the current point after the last segment.
+ */
+typedef struct cmd_shared_path_s {
+    byte *data;
+    uint size;
+    uint alloc_size;
+    int64_t pos;
+    gs_fixed_point end;
+} cmd_shared_path;
+
+/* Paths smaller than this are cheaper to write into each band. */
+#define CMD_SHARED_PATH_MIN 512
+
 /* Forward declarations */
 static int cmd_put_path(gx_device_clist_writer * cldev,
                          gx_clist_state * pcls, const gx_path * ppath,
                          fixed ymin, fixed ymax, byte op,
                          bool implicit_close, segment_notes keep_notes);
+static int cmd_put_shared_path(gx_device_clist_writer * cldev,
+                                cmd_shared_path * psp, const gx_path * ppath,
+                                bool implicit_close, segment_notes keep_notes);
+static int cmd_put_shared_path_ref(gx_device_clist_writer * cldev,
+                                    gx_clist_state * pcls,
+                                    const cmd_shared_path * psp, byte op);
 
 /* ------ Utilities ------ */
 
@@ -971,6 +995,8 @@ clist_fill_stroke_path(gx_device * pdev, const gs_gstate * pgs,
     gs_logical_operation_t lop = pgs->log_op;
     bool slow_rop = cmd_slow_rop(pdev, lop_know_S_0(lop), pdevc_fill);
     cmd_rects_enum_t re;
+    cmd_shared_path shared;
+    int use_shared = 0;
 
     if (pdevc_stroke == NULL || pdevc_fill == NULL)
         return_error(gs_error_unknownerror);	/* shouldn't happen */
@@ -1095,6 +1121,13 @@ clist_fill_stroke_path(gx_device * pdev, const gs_gstate * pgs,
         unknown |= op_bm_tk_known;
     }
     RECT_ENUM_INIT(re, ry, rheight);
+    /* The whole path goes into every band, so write it only once. */
+    if (re.rect_nbands > 1) {
+        use_shared = cmd_put_shared_path(cdev, &shared, ppath, false,
+                                         (segment_notes)~0);
+        if (use_shared < 0)
+            return use_shared;
+    }
     do {
         int code;
 
@@ -1123,8 +1156,11 @@ clist_fill_stroke_path(gx_device * pdev, const gs_gstate * pgs,
 
         /* Don't skip segments when expansion is unknown.  */
 
-        code = cmd_put_path(cdev, re.pcls, ppath, min_fixed, max_fixed,
-                            op, false, (segment_notes)~0);
+        if (use_shared)
+            code = cmd_put_shared_path_ref(cdev, re.pcls, &shared, op);
+        else
+            code = cmd_put_path(cdev, re.pcls, ppath, min_fixed, max_fixed,
+                                op, false, (segment_notes)~0);
         if (code < 0)
             return code;
         re.y += re.height;
@@ -1148,6 +1184,8 @@ clist_stroke_path(gx_device * dev, const gs_gstate * pgs, gx_path * ppath,
     gs_logical_operation_t lop = pgs->log_op;
     bool slow_rop = cmd_slow_rop(dev, lop_know_S_0(lop), pdcolor);
     cmd_rects_enum_t re;
+    cmd_shared_path shared;
+    int use_shared = 0;
 
     CMD_CHECK_LAST_OP_BLOCK_DEFINED(cdev);
     if ((cdev->disable_mask & clist_disable_stroke_path) ||
@@ -1259,6 +1297,16 @@ clist_stroke_path(gx_device * dev, const gs_gstate * pgs, gx_path * ppath,
         clist_update_trans_bbox(cdev, &trans_bbox);
     }
     RECT_ENUM_INIT(re, ry, rheight);
+    /*
+     * If segments can't be skipped (see below), the whole path goes into
+     * every band, so write it only once.
+     */
+    if ((pattern_size || expansion_code < 0) && re.rect_nbands > 1) {
+        use_shared = cmd_put_shared_path(cdev, &shared, ppath, false,
+                                         (segment_notes)~0);
+        if (use_shared < 0)
+            return use_shared;
+    }
     do {
         int code;
 
@@ -1306,9 +1354,13 @@ clist_stroke_path(gx_device * dev, const gs_gstate * pgs, gx_path * ppath,
                 ymin = int2fixed(re.y - adjust_y);
                 ymax = int2fixed(re.y + re.height + adjust_y);
             }
-            code = cmd_put_path(cdev, re.pcls, ppath, ymin, ymax,
-                                cmd_opv_stroke,
-                                false, (segment_notes)~0);
+            if (use_shared)
+                code = cmd_put_shared_path_ref(cdev, re.pcls, &shared,
+                                               cmd_opv_stroke);
+            else
+                code = cmd_put_path(cdev, re.pcls, ppath, ymin, ymax,
+                                    cmd_opv_stroke,
+                                    false, (segment_notes)~0);
             if (code < 0)
                 return code;
         }
@@ -1441,15 +1493,60 @@ typedef struct cmd_segment_writer_s {
     /* Set at initialization */
     gx_device_clist_writer *cldev;
     gx_clist_state *pcls;
+    cmd_shared_path *psp;	/* if pcls == 0, buffer for a shared path */
     /* Updated dynamically */
     segment_notes notes;
     byte *dp;
     int len;
     gs_fixed_point delta_first;
+    byte initial_op;
     byte cmd[6 * (1 + sizeof(fixed))];
 }
 cmd_segment_writer;
 
+/* Allocate space for a path command, in the band or in the shared buffer. */
+static int
+cmd_segment_put_op(cmd_segment_writer * psw, byte **dp, int op, uint csize)
+{
+    cmd_shared_path *psp = psw->psp;
+
+    if (psw->pcls != NULL)
+        return set_cmd_put_op(dp, psw->cldev, psw->pcls, op, csize);
+    if (psp->size + csize > psp->alloc_size) {
+        uint new_size = max(psp->alloc_size * 2, psp->size + csize);
+        byte *data;
+
+        if (new_size < 4096)
+            new_size = 4096;
+        data = gs_alloc_bytes(psw->cldev->memory, new_size,
+                              "cmd_segment_put_op");
+        if (data == NULL)
+            return_error(gs_error_VMerror);
+        if (psp->size)
+            memcpy(data, psp->data, psp->size);
+        /* The last command may be merged with the next one. */
+        if (psw->dp != &psw->initial_op)
+            psw->dp = data + (psw->dp - psp->data);
+        gs_free_object(psw->cldev->memory, psp->data, "cmd_segment_put_op");
+        psp->data = data;
+        psp->alloc_size = new_size;
+    }
+    *dp = psp->data + psp->size;
+    **dp = op;
+    psp->size += csize;
+    return 0;
+}
+
+/* Remove the last command written by cmd_segment_put_op. */
+static void
+cmd_segment_shorten_op(cmd_segment_writer * psw, int delta)
+{
+    if (psw->pcls != NULL)
+        cmd_shorten_op(psw->cldev, psw->pcls, delta);
+    else
+        psw->psp->size -= delta;
+}
+
 /* Put out a path segment command. */
 static int
 cmd_put_segment(cmd_segment_writer * psw, byte op,
@@ -1491,7 +1588,7 @@ cmd_put_segment(cmd_segment_writer * psw, byte op,
                     psw->delta_first.y = operands[1];
                     op = cmd_opv_rmlineto;
                   merge:cmd_uncount_op(*psw->dp, psw->len);
-                    cmd_shorten_op(psw->cldev, psw->pcls, psw->len);	/* delete it */
+                    cmd_segment_shorten_op(psw, psw->len);	/* delete it */
                     q += psw->len - 1;
                     break;
                 case cmd_opv_rmlineto:
@@ -1556,8 +1653,7 @@ cmd_put_segment(cmd_segment_writer * psw, byte op,
     }
     if (notes != psw->notes) {
         byte *dp;
-        int code =
-            set_cmd_put_op(&dp, psw->cldev, psw->pcls, cmd_opv_set_misc2, 3);
+        int code = cmd_segment_put_op(psw, &dp, cmd_opv_set_misc2, 3);
 
         if (code < 0)
             return code;
@@ -1567,7 +1663,7 @@ cmd_put_segment(cmd_segment_writer * psw, byte op,
     } {
         int len = q + 2 - psw->cmd;
         byte *dp;
-        int code = set_cmd_put_op(&dp, psw->cldev, psw->pcls, op, len);
+        int code = cmd_segment_put_op(psw, &dp, op, len);
 
         if (code < 0)
             return code;
@@ -1627,26 +1723,19 @@ reduce_line(fixed *m0, fixed *m1, fixed x0, fixed y0, fixed x1, fixed y1)
 }
 
 /*
- * Write a path.  We go to a lot of trouble to omit segments that are
- * entirely outside the band.
+ * Write a path, either into the band of pcls, followed by path_op, or
+ * (if pcls is 0) into the shared path buffer psp.  We go to a lot of
+ * trouble to omit segments that are entirely outside the band.
  */
 static int
-cmd_put_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
-             const gx_path * ppath, fixed ymin, fixed ymax, byte path_op,
-             bool implicit_close, segment_notes keep_notes)
+cmd_write_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
+               cmd_shared_path * psp,
+               const gx_path * ppath, fixed ymin, fixed ymax, byte path_op,
+               bool implicit_close, segment_notes keep_notes)
 {
     gs_path_enum cenum;
     cmd_segment_writer writer;
 
-    /*
-     * initial_op is logically const.  We would like to declare it as
-     * static const, since some systems really dislike non-const statics,
-     * but this would entail a cast in set_first_point() that provokes a
-     * warning message from gcc.  Instead, we pay the (tiny) cost of an
-     * unnecessary dynamic initialization.
-     */
-    byte initial_op = cmd_opv_end_run;
-
     /*
      * We define the 'side' of a point according to its Y value as
      * follows:
@@ -1690,9 +1779,9 @@ cmd_put_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
      * The following track the emitted segments:
      */
 
-    /* The last point emitted: */
-    fixed px = int2fixed(pcls->rect.x);
-    fixed py = int2fixed(pcls->rect.y);
+    /* The last point emitted (shared paths start from the origin): */
+    fixed px = (pcls != NULL ? int2fixed(pcls->rect.x) : 0);
+    fixed py = (pcls != NULL ? int2fixed(pcls->rect.y) : 0);
 
     /* The point of the last emitted moveto: */
     gs_fixed_point first;
@@ -1709,9 +1798,11 @@ cmd_put_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
     gx_path_enum_init(&cenum, ppath);
     writer.cldev = cldev;
     writer.pcls = pcls;
+    writer.psp = psp;
     writer.notes = sn_none;
-#define set_first_point() (writer.dp = &initial_op)
-#define first_point() (writer.dp == &initial_op)
+    writer.initial_op = cmd_opv_end_run;
+#define set_first_point() (writer.dp = &writer.initial_op)
+#define first_point() (writer.dp == &writer.initial_op)
     set_first_point();
     for (;;) {
         fixed vs[6];
@@ -1733,6 +1824,11 @@ cmd_put_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
                 if (open > 0 && implicit_close)
                     goto close;
                 /* All done. */
+                if (pcls == NULL) {
+                    psp->end.x = px;
+                    psp->end.y = py;
+                    return 0;
+                }
                 pcls->rect.x = fixed2int_var(px);
                 pcls->rect.y = fixed2int_var(py);
                 if_debug2m('p', cldev->memory, "[p]final (%d,%d)\n",
@@ -2079,3 +2175,62 @@ cmd_put_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
 #undef F
     }
 }
+
+static int
+cmd_put_path(gx_device_clist_writer * cldev, gx_clist_state * pcls,
+             const gx_path * ppath, fixed ymin, fixed ymax, byte path_op,
+             bool implicit_close, segment_notes keep_notes)
+{
+    return cmd_write_path(cldev, pcls, NULL, ppath, ymin, ymax, path_op,
+                          implicit_close, keep_notes);
+}
+
+/*
+ * Write the whole of a path into a pseudo-band record.  Return 1 if it was
+ * written, or 0 if the path is too small to be worth sharing, in which case
+ * the caller should write it into each band as usual.
+ */
+static int
+cmd_put_shared_path(gx_device_clist_writer * cldev, cmd_shared_path * psp,
+                    const gx_path * ppath, bool implicit_close,
+                    segment_notes keep_notes)
+{
+    int code;
+
+    memset(psp, 0, sizeof(*psp));
+    code = cmd_write_path(cldev, NULL, psp, ppath, min_fixed, max_fixed, 0,
+                          implicit_close, keep_notes);
+    if (code >= 0 && psp->size >= CMD_SHARED_PATH_MIN) {
+        psp->pos = cldev->page_info.io_procs->ftell(cldev->page_info.cfile);
+        code = cmd_write_pseudo_band(cldev, psp->data, psp->size,
+                                     SHARED_PATH_OFFSET);
+        if (code >= 0) {
+            if_debug2m('L', cldev->memory, "[L]shared path %u bytes at %"PRId64"\n",
+                       psp->size, psp->pos);
+            code = 1;
+        }
+    }
+    gs_free_object(cldev->memory, psp->data, "cmd_put_shared_path");
+    psp->data = NULL;
+    return code;
+}
+
+/* Refer to a shared path from a band, and put out the path operation. */
+static int
+cmd_put_shared_path_ref(gx_device_clist_writer * cldev, gx_clist_state * pcls,
+                        const cmd_shared_path * psp, byte path_op)
+{
+    byte *dp;
+    int code = set_cmd_put_extended_op(&dp, cldev, pcls,
+                                       cmd_opv_ext_shared_path,
+                                       2 + sizeof(psp->pos) + sizeof(psp->size));
+
+    if (code < 0)
+        return code;
+    memcpy(dp + 2, &psp->pos, sizeof(psp->pos));
+    memcpy(dp + 2 + sizeof(psp->pos), &psp->size, sizeof(psp->size));
+    /* Leave the band's current point where playback will leave it. */
+    pcls->rect.x = fixed2int_var(psp->end.x);
+    pcls->rect.y = fixed2int_var(psp->end.y);
+    return set_cmd_put_op(&dp, cldev, pcls, path_op, 1);
+}
@@ -86,7 +86,10 @@ typedef enum {
     cmd_opv_ext_put_tile_devn_color0 = 0x07, /* Devn color0 for tile filling */
     cmd_opv_ext_put_tile_devn_color1 = 0x08, /* Devn color1 for tile filling */
     cmd_opv_ext_set_color_is_devn    = 0x09, /* Used for overload of copy_color_alpha */
-    cmd_opv_ext_unset_color_is_devn  = 0x0a  /* Used for overload of copy_color_alpha */
+    cmd_opv_ext_unset_color_is_devn  = 0x0a, /* Used for overload of copy_color_alpha */
+    cmd_opv_ext_shared_path          = 0x0b  /* cfile position, size of
+                                              * path segments written once
+                                              * for several bands */
 } gx_cmd_ext_op;
 
 #ifdef DEBUG
@@ -101,7 +104,8 @@ typedef enum {
   "put_tile_devn_color0",\
   "put_tile_devn_color1",\
   "set_color_is_devn",\
-  "unset_color_is_devn"
+  "unset_color_is_devn",\
+  "shared_path"
 
 extern const char *cmd_extend_op_names[256];
 #endif
@@ -291,6 +291,11 @@ static int cmd_select_map(cmd_map_index, cmd_map_contents,
 static int cmd_create_dev_ht(gx_device_halftone **, gs_memory_t *);
 static int cmd_resize_halftone(gx_device_halftone **, uint,
                                 gs_memory_t *);
+static const byte *cmd_read_segment_operands(const byte *, int, fixed[6],
+                                             gs_memory_t *);
+static int clist_read_shared_path(const stream_state *, int64_t, uint,
+                                  gx_path *, gs_fixed_point *, int, int,
+                                  gs_memory_t *);
 static int clist_decode_segment(gx_path *, int, fixed[6],
                                  gs_fixed_point *, int, int,
                                  segment_notes);
@@ -579,9 +584,7 @@ clist_playback_band(clist_playback_action playback_action, /* lgtm [cpp/use-of-g
     int op = 0;
     int plane_height = 0;
 
-#ifdef DEBUG
     stream_state *st = s->state; /* Save because s_close resets s->state. */
-#endif
     gs_composite_t *pcomp_first = NULL, *pcomp_last = NULL;
     tile_slot bits;             /* parameters for reading bits */
 
@@ -1853,6 +1856,23 @@ idata:                  data_size = 0;
                                 if (code < 0)
                                     goto out;
                                 break;
+                            case cmd_opv_ext_shared_path:
+                                {
+                                    int64_t pos;
+                                    uint size;
+
+                                    cmd_get_value(pos, cbp);
+                                    cmd_get_value(size, cbp);
+                                    if_debug2m('L', mem, " shared_path %u bytes at %"PRId64"\n",
+                                               size, pos);
+                                    /* The path op that uses it follows. */
+                                    in_path = true;
+                                    code = clist_read_shared_path(st, pos, size, &path, &ppos,
+                                                                  x0, y0, mem);
+                                    if (code < 0)
+                                        goto out;
+                                }
+                                break;
                             case cmd_opv_ext_set_color_is_devn:
                                 state.color_is_devn = true;
                                 if_debug0m('L', mem, " ext_set_color_is_devn\n");
@@ -1946,10 +1966,6 @@ idata:                  data_size = 0;
                 continue;
             case cmd_op_segment >> 4:
                 {
-                    int i;
-                    static const byte op_num_operands[] = {
-                        cmd_segment_op_num_operands_values
-                    };
                   rgapto:
                     if (!in_path) {
                         ppos.x = int2fixed(state.rect.x);
@@ -1959,56 +1975,7 @@ idata:                  data_size = 0;
                         notes = sn_none;
                         in_path = true;
                     }
-                    for (i = 0; i < op_num_operands[op & 0xf]; ++i) {
-                        fixed v;
-                        int b = *cbp;
-
-                        switch (b >> 5) {
-                            case 0:
-                            case 1:
-                                vs[i++] =
-                                    ((fixed) ((b ^ 0x20) - 0x20) << 13) +
-                                    ((int)cbp[1] << 5) + (cbp[2] >> 3);
-                                if_debug1m('L', mem, " %g", fixed2float(vs[i - 1]));
-                                cbp += 2;
-                                v = (int)((*cbp & 7) ^ 4) - 4;
-                                break;
-                            case 2:
-                            case 3:
-                                v = (b ^ 0x60) - 0x20;
-                                break;
-                            case 4:
-                            case 5:
-                                /*
-                                 * Without the following cast, C's
-                                 * brain-damaged coercion rules cause the
-                                 * result to be considered unsigned, and not
-                                 * sign-extended on machines where
-                                 * sizeof(long) > sizeof(int).
-                                 */
-                                v = (((b ^ 0xa0) - 0x20) << 8) + (int)*++cbp;
-                                break;
-                            case 6:
-                                v = (b ^ 0xd0) - 0x10;
-                                vs[i] =
-                                    ((v << 8) + cbp[1]) << (_fixed_shift - 2);
-                                if_debug1m('L', mem, " %g", fixed2float(vs[i]));
-                                cbp += 2;
-                                continue;
-                            default /*case 7 */ :
-                                v = (int)(*++cbp ^ 0x80) - 0x80;
-                                for (b = 0; b < sizeof(fixed) - 3; ++b)
-                                    v = (v << 8) + *++cbp;
-                                break;
-                        }
-                        cbp += 3;
-                        /* Absent the cast in the next statement, */
-                        /* the Borland C++ 4.5 compiler incorrectly */
-                        /* sign-extends the result of the shift. */
-                        vs[i] = (v << 16) + (uint) (cbp[-2] << 8) + cbp[-1];
-                        if_debug1m('L', mem, " %g", fixed2float(vs[i]));
-                    }
-                    if_debug0m('L', mem, "\n");
+                    cbp = cmd_read_segment_operands(cbp, op, vs, mem);
                     code = clist_decode_segment(&path, op, vs, &ppos,
                                                 x0, y0, notes);
                     if (code < 0)
@@ -3374,6 +3341,123 @@ cmd_resize_halftone(gx_device_halftone **ppdht, uint num_comp,
 
 /* ------ Path operations ------ */
 
+/* Read the operands of a path segment command. */
+static const byte *
+cmd_read_segment_operands(const byte *cbp, int op, fixed vs[6], gs_memory_t *mem)
+{
+    int i;
+    static const byte op_num_operands[] = {
+        cmd_segment_op_num_operands_values
+    };
+
+    for (i = 0; i < op_num_operands[op & 0xf]; ++i) {
+        fixed v;
+        int b = *cbp;
+
+        switch (b >> 5) {
+            case 0:
+            case 1:
+                vs[i++] =
+                    ((fixed) ((b ^ 0x20) - 0x20) << 13) +
+                    ((int)cbp[1] << 5) + (cbp[2] >> 3);
+                if_debug1m('L', mem, " %g", fixed2float(vs[i - 1]));
+                cbp += 2;
+                v = (int)((*cbp & 7) ^ 4) - 4;
+                break;
+            case 2:
+            case 3:
+                v = (b ^ 0x60) - 0x20;
+                break;
+            case 4:
+            case 5:
+                /*
+                 * Without the following cast, C's
+                 * brain-damaged coercion rules cause the
+                 * result to be considered unsigned, and not
+                 * sign-extended on machines where
+                 * sizeof(long) > sizeof(int).
+                 */
+                v = (((b ^ 0xa0) - 0x20) << 8) + (int)*++cbp;
+                break;
+            case 6:
+                v = (b ^ 0xd0) - 0x10;
+                vs[i] =
+                    ((v << 8) + cbp[1]) << (_fixed_shift - 2);
+                if_debug1m('L', mem, " %g", fixed2float(vs[i]));
+                cbp += 2;
+                continue;
+            default /*case 7 */ :
+                v = (int)(*++cbp ^ 0x80) - 0x80;
+                for (b = 0; b < sizeof(fixed) - 3; ++b)
+                    v = (v << 8) + *++cbp;
+                break;
+        }
+        cbp += 3;
+        /* Absent the cast in the next statement, */
+        /* the Borland C++ 4.5 compiler incorrectly */
+        /* sign-extends the result of the shift. */
+        vs[i] = (v << 16) + (uint) (cbp[-2] << 8) + cbp[-1];
+        if_debug1m('L', mem, " %g", fixed2float(vs[i]));
+    }
+    if_debug0m('L', mem, "\n");
+    return cbp;
+}
+
+/*
+ * Read the segments of a path that the writer put into a pseudo-band
+ * record once for several bands (see cmd_opv_ext_shared_path).  The
+ * segments are relative to (0,0), and may be preceded by changes of the
+ * segment notes, written as for set_misc2.
+ */
+static int
+clist_read_shared_path(const stream_state *st, int64_t pos, uint size,
+                       gx_path *ppath, gs_fixed_point *ppos, int x0, int y0,
+                       gs_memory_t *mem)
+{
+    /* Padding so that a damaged last command can't read past the end. */
+    const uint pad = 6 * (1 + sizeof(fixed));
+    segment_notes notes = sn_none;
+    const byte *p, *end;
+    byte *buf;
+    fixed vs[6];
+    int code;
+
+    buf = gs_alloc_bytes(mem, size + pad, "clist_read_shared_path");
+    if (buf == NULL)
+        return_error(gs_error_VMerror);
+    code = clist_read_band_stream_chunk(st, pos, size, buf);
+    memset(buf + size, 0, pad);
+    p = buf;
+    end = buf + size;
+    ppos->x = ppos->y = 0;
+    while (code >= 0 && p < end) {
+        int op = *p++;
+
+        if (op == cmd_opv_set_misc2) {
+            if (p[0] != segment_notes_known) {
+                code = gs_note_error(gs_error_rangecheck);
+                break;
+            }
+            notes = (segment_notes)p[1];
+            p += 2;
+            continue;
+        }
+        if ((op >> 4) != (cmd_op_segment >> 4) && op != cmd_opv_rgapto) {
+            code = gs_note_error(gs_error_rangecheck);
+            break;
+        }
+        if_debug1m('L', mem, "[L]  shared %s:", cmd_sub_op_names[op >> 4][op & 0xf]);
+        p = cmd_read_segment_operands(p, op, vs, mem);
+        if (p > end) {
+            code = gs_note_error(gs_error_rangecheck);
+            break;
+        }
+        code = clist_decode_segment(ppath, op, vs, ppos, x0, y0, notes);
+    }
+    gs_free_object(mem, buf, "clist_read_shared_path");
+    return code;
+}
+
 /* Decode a path segment. */
 static int
 clist_decode_segment(gx_path * ppath, int op, fixed vs[6],
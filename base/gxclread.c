@@ -568,6 +568,26 @@ clist_read_chunk(gx_device_clist_reader *crdev, int64_t position, int size, unsi
     return 0;
 }
 
+/* Read a chunk of data from the cfile of a band stream (which is not always
+ * the reader device's own cfile, e.g. for saved pages). */
+int
+clist_read_band_stream_chunk(const stream_state *st, int64_t position, int size, byte *buf)
+{
+    const stream_band_read_state *ss = (const stream_band_read_state *) st;
+    const clist_io_procs_t *io_procs = ss->page_info.io_procs;
+    clist_file_ptr cfile = ss->page_info.cfile;
+    int64_t save_pos;
+    int nread;
+
+    save_pos = io_procs->ftell(cfile);
+    io_procs->fseek(cfile, position, SEEK_SET, ss->page_info.cfname);
+    nread = io_procs->fread_chars(buf, size, cfile);
+    io_procs->fseek(cfile, save_pos, SEEK_SET, ss->page_info.cfname);
+    if (nread < size)
+        return_error(gs_error_ioerror);
+    return 0;
+}
+
 /* read the color_usage_array back from the pseudo band */
 int
 clist_read_color_usage_array(gx_device_clist_reader *crdev)
@@ -705,6 +725,7 @@ clist_render_init(gx_device_clist *dev)
     crdev->icc_table = NULL;
     crdev->color_usage_array = NULL;
     crdev->render_threads = NULL;
+    crdev->compose_budget = NULL;
 
     return 0;
 }
@@ -303,6 +303,50 @@ out_cleanup:
     return NULL;
 }
 
+static void
+clist_free_compose_budget(gx_device_clist_reader *crdev, gs_memory_t *mem)
+{
+    if (crdev->compose_budget != NULL) {
+        gx_monitor_free(crdev->compose_budget->lock);
+        gs_free_object(mem, crdev->compose_budget, "clist_free_compose_budget");
+        crdev->compose_budget = NULL;
+    }
+}
+
+static void
+clist_compose_budget_adjust(clist_compose_budget_t *budget, int delta)
+{
+    if (budget == NULL)
+        return;
+    gx_monitor_enter(budget->lock);
+    budget->available += delta;
+    gx_monitor_leave(budget->lock);
+}
+
+int
+clist_compose_threads_reserve(gx_device_clist_reader *crdev, int wanted)
+{
+    clist_compose_budget_t *budget = crdev->compose_budget;
+    int count;
+
+    if (budget == NULL || wanted <= 0)
+        return 0;
+    gx_monitor_enter(budget->lock);
+    count = min(wanted, budget->available);
+    if (count < 0)
+        count = 0;
+    budget->available -= count;
+    gx_monitor_leave(budget->lock);
+    return count;
+}
+
+void
+clist_compose_threads_release(gx_device_clist_reader *crdev, int count)
+{
+    if (count > 0)
+        clist_compose_budget_adjust(crdev->compose_budget, count);
+}
+
 /* Set up and start the render threads */
 static int
 clist_setup_render_threads(gx_device *dev, int y, gx_process_page_options_t *options)
@@ -403,6 +447,16 @@ clist_setup_render_threads(gx_device *dev, int y, gx_process_page_options_t *opt
         gs_free_object(mem, old, "clist_render_setup_threads");
     }
 
+    /* Without a budget, the render threads don't split up pdf14 groups */
+    crdev->compose_budget = (clist_compose_budget_t *)gs_alloc_bytes(mem, sizeof(clist_compose_budget_t),
+                                                                     "clist_setup_render_threads");
+    if (crdev->compose_budget != NULL) {
+        crdev->compose_budget->available = 0;
+        crdev->compose_budget->lock = gx_monitor_label(gx_monitor_alloc(mem), "Compose budget");
+        if (crdev->compose_budget->lock == NULL)
+            clist_free_compose_budget(crdev, mem);
+    }
+
     /* Loop creating the devices and semaphores for each thread, then start them */
     for (i=0; (i < crdev->num_render_threads) && (band >= 0) && (band < band_count);
             i++, band += crdev->thread_lookahead_direction) {
@@ -423,6 +477,9 @@ clist_setup_render_threads(gx_device *dev, int y, gx_process_page_options_t *opt
             break;
         }
 
+        /* The pdf14 compositor in this thread may borrow idle threads */
+        ((gx_device_clist *)ndev)->reader.compose_budget = crdev->compose_budget;
+
         thread->cdev = ndev;
         thread->memory = ndev->memory;
         thread->band = -1;              /* a value that won't match any valid band */
@@ -482,6 +539,7 @@ clist_setup_render_threads(gx_device *dev, int y, gx_process_page_options_t *opt
     /* Although a single thread isn't any more efficient, the   */
     /* machinery still works, so that's OK.                     */
     if (i == 0) {
+        clist_free_compose_budget(crdev, mem);
         if (crdev->render_threads[0].memory != NULL) {
             gs_memory_chunk_release(crdev->render_threads[0].memory);
             if (chunk_base_mem != mem) {
@@ -510,6 +568,8 @@ clist_setup_render_threads(gx_device *dev, int y, gx_process_page_options_t *opt
      * threads since we deferred that in the thread setup loop above.
      * We know if we get here we can start at least 1 thread.
      */
+    if (crdev->compose_budget != NULL)
+        crdev->compose_budget->available = i;
     for (j=0, code = 0; j<crdev->num_render_threads; j++) {
         gs_free_object(mem, reserve_memory_array[j], "clist_setup_render_threads");
         if (code == 0 && j < i)
@@ -639,6 +699,7 @@ clist_teardown_render_threads(gx_device *dev)
         }
         gs_free_object(mem, crdev->render_threads, "clist_teardown_render_threads");
         crdev->render_threads = NULL;
+        clist_free_compose_budget(crdev, mem);
 
         /* Now re-open the clist temp files so we can write to them */
         if (cdev->page_info.cfile == NULL) {
@@ -666,10 +727,15 @@ clist_start_render_thread(gx_device *dev, int thread_index, int band)
     crdev->render_threads[thread_index].band = band;
     crdev->render_threads[thread_index].status = THREAD_BUSY;
 
+    /* The thread gives this back when it has rendered the band */
+    clist_compose_budget_adjust(crdev->compose_budget, -1);
+
     /* Finally, fire it up */
     code = gp_thread_start(clist_render_thread,
                            &(crdev->render_threads[thread_index]),
                            &(crdev->render_threads[thread_index].thread));
+    if (code < 0)
+        clist_compose_budget_adjust(crdev->compose_budget, 1);
     gp_thread_label(crdev->render_threads[thread_index].thread, "Band");
 
     return code;
@@ -723,6 +789,8 @@ clist_render_thread(void *data)
     else
         thread->status = THREAD_DONE;    /* OK */
 
+    clist_compose_budget_adjust(crdev->compose_budget, 1);
+
 #ifdef DEBUG
     gp_get_usertime(endtime);
     thread->cputime += (endtime[0] - starttime[0]) * 1000 +
@@ -38,6 +38,21 @@ gx_device * setup_device_and_mem_for_thread(gs_memory_t *chunk_base_mem, gx_devi
 /* Exported for use by background printing.                             */
 void teardown_device_and_mem_for_thread(gx_device *dev, gp_thread_id thread_id, bool bg_print);
 
+/* The threads a page's band rendering may keep busy, shared by the render */
+/* threads. Each band being rendered uses one, and the pdf14 compositor of */
+/* a render thread may borrow those left over (at the end of the page, for */
+/* instance) to compose large groups in slices.                            */
+typedef struct clist_compose_budget_s {
+    gx_monitor_t *lock;
+    int available;              /* threads not in use */
+} clist_compose_budget_t;
+
+/* Reserve up to 'wanted' threads from the budget of the page a render      */
+/* thread's device belongs to. Returns the number reserved (possibly 0),    */
+/* which must be given back with clist_compose_threads_release.             */
+int clist_compose_threads_reserve(gx_device_clist_reader *crdev, int wanted);
+void clist_compose_threads_release(gx_device_clist_reader *crdev, int count);
+
 /* Following is used for clist background printing and multi-threaded rendering */
 typedef enum {
     THREAD_ERROR = -1,
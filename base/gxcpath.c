@@ -32,6 +32,7 @@
 
 /* Forward references */
 static void gx_clip_list_from_rectangle(gx_clip_list *, gs_fixed_rect *);
+static void clip_list_free_index(gx_clip_list *, gs_memory_t *);
 
 /* Other structure types */
 public_st_clip_rect();
@@ -40,6 +41,11 @@ public_st_clip_path();
 private_st_clip_rect_list();
 public_st_device_clip();
 private_st_cpath_path_list();
+gs_private_st_ptr(st_clip_rect_ptr, gx_clip_rect *, "gx_clip_rect *",
+                  clip_rect_ptr_enum_ptrs, clip_rect_ptr_reloc_ptrs);
+gs_private_st_element(st_clip_rect_ptr_element, gx_clip_rect *,
+                      "gx_clip_rect *[]", clip_rect_ptr_element_enum_ptrs,
+                      clip_rect_ptr_element_reloc_ptrs, st_clip_rect_ptr);
 
 /* GC procedures for gx_clip_path */
 static
@@ -116,7 +122,9 @@ static const gx_clip_list clip_list_empty = {
     0, /* xmin */
     0, /* xmax */
     0, /* count */
-    0  /* transpose = false */
+    0, /* transpose = false */
+    0, /* index */
+    0  /* index_count */
 };
 
 /* ------ Clipping path memory management ------ */
@@ -793,6 +801,8 @@ gx_cpath_scale_exp2_shared(gx_clip_path * pcpath, int log2_scale_x,
     gx_rect_scale_exp2(&pcpath->inner_box, log2_scale_x, log2_scale_y);
     gx_rect_scale_exp2(&pcpath->outer_box, log2_scale_x, log2_scale_y);
     if (!list_shared) {
+        /* Scaling down can merge rows, so drop any row index. */
+        clip_list_free_index(list, pcpath->rect_list->rc.memory);
         /* Scale the clipping list. */
         pr = list->head;
         if (pr == 0)
@@ -824,6 +834,53 @@ gx_cpath_scale_exp2_shared(gx_clip_path * pcpath, int log2_scale_x,
 
 /* ------ Clipping list routines ------ */
 
+/*
+ * Don't bother indexing lists shorter than this: walking a few rows from
+ * the cursor is as cheap as the binary search.
+ */
+#define CLIP_LIST_INDEX_MIN_COUNT 64
+
+/* Free the row index of a clip list, if any. */
+static void
+clip_list_free_index(gx_clip_list * clp, gs_memory_t * mem)
+{
+    if (clp->index != 0) {
+        gs_free_object(mem, clp->index, "clip_list_free_index");
+        clp->index = 0;
+        clp->index_count = 0;
+    }
+}
+
+/* Build the row index of a clipping path's rectangle list. */
+void
+gx_cpath_index_list(const gx_clip_path *pcpath)
+{
+    gx_clip_list *clp = gx_cpath_list_private(pcpath);
+    gs_memory_t *mem = pcpath->rect_list->rc.memory;
+    gx_clip_rect *rp;
+    gx_clip_rect **index;
+    int n = 0;
+
+    if (clp->index != 0 || clp->count < CLIP_LIST_INDEX_MIN_COUNT ||
+        clp->head == 0 || mem == 0)
+        return;
+    /* Rows are runs of rectangles with the same ymax. */
+    for (rp = clp->head; rp != 0; rp = rp->next)
+        if (rp->prev == 0 || rp->ymax != rp->prev->ymax)
+            n++;
+    index = gs_alloc_struct_array(mem, n, gx_clip_rect *,
+                                  &st_clip_rect_ptr_element,
+                                  "gx_cpath_index_list");
+    if (index == 0)
+        return;
+    n = 0;
+    for (rp = clp->head; rp != 0; rp = rp->next)
+        if (rp->prev == 0 || rp->ymax != rp->prev->ymax)
+            index[n++] = rp;
+    clp->index = index;
+    clp->index_count = n;
+}
+
 /* Initialize a clip list. */
 void
 gx_clip_list_init(gx_clip_list * clp)
@@ -1082,6 +1139,8 @@ gx_clip_list_free(gx_clip_list * clp, gs_memory_t * mem)
 {
     gx_clip_rect *rp = clp->tail;
 
+    clip_list_free_index(clp, mem);
+
     while (rp != 0) {
         gx_clip_rect *prev = rp->prev;
 
@@ -74,12 +74,15 @@ struct gx_clip_list_s {
     int count;			/* # of rectangles not counting */
                                 /* head or tail */
     bool transpose;		/* Transpose x / y */
+    gx_clip_rect **index;	/* first rectangle of each row, */
+                                /* including head and tail, or 0 */
+    int index_count;		/* # of entries in index */
 };
 
 #define public_st_clip_list()	/* in gxcpath.c */\
-  gs_public_st_ptrs2(st_clip_list, gx_clip_list, "clip_list",\
-    clip_list_enum_ptrs, clip_list_reloc_ptrs, head, tail)
-#define st_clip_list_max_ptrs 2	/* head, tail */
+  gs_public_st_ptrs3(st_clip_list, gx_clip_list, "clip_list",\
+    clip_list_enum_ptrs, clip_list_reloc_ptrs, head, tail, index)
+#define st_clip_list_max_ptrs 3	/* head, tail, index */
 #define clip_list_is_rectangle(clp) ((clp)->count <= 1)
 
 /*
@@ -156,4 +159,13 @@ void gx_cpath_set_outer_box(gx_clip_path *);
 /* Return the rectangle list of a clipping path (for local use only). */
 const gx_clip_list *gx_cpath_list(const gx_clip_path *pcpath);
 
+/*
+ * Build the row index of a long rectangle list, if it doesn't have one yet.
+ * The index lets the clipping device find the first rectangle that could
+ * include a given Y with a binary search rather than a walk along the list.
+ * Failure to allocate the index is not an error: the list just stays
+ * unindexed.
+ */
+void gx_cpath_index_list(const gx_clip_path *pcpath);
+
 #endif /* gxcpath_INCLUDED */
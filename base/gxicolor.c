@@ -440,6 +440,193 @@ decode_row(const gx_image_enum *penum, const byte *psrc, int spp, byte *pdes,
     }
 }
 
+/*
+ * Flat graphics saved as RGB or CMYK images repeat the same few colors over
+ * and over. For those we keep a memo of the device colors of recently seen
+ * source pixels in an open-addressed hash table, and only send the pixels
+ * that are not in it through the CMM. Each distinct missing color is
+ * converted once per row, however often it occurs in the row.
+ *
+ * If the first rows of an image show little repetition (a photograph), the
+ * memo is switched off for the rest of the image.
+ */
+#define IMAGE_COLOR_MEMO_SIZE 4096	/* must be a power of 2 */
+#define IMAGE_COLOR_MEMO_PROBES 4
+#define IMAGE_COLOR_MEMO_MAX_DES 4
+#define IMAGE_COLOR_MEMO_TRIAL_ROWS 8
+#define IMAGE_COLOR_MEMO_MIN_WIDTH 16
+
+enum {
+    memo_empty = 0,
+    memo_valid,
+    memo_pending		/* converted at the end of the current row */
+};
+
+typedef struct image_color_memo_entry_s {
+    bits32 key;
+    byte state;
+    byte device_contone[IMAGE_COLOR_MEMO_MAX_DES];
+    uint pending;		/* index of the color in the row's missing colors */
+} image_color_memo_entry_t;
+
+struct gx_image_color_memo_s {
+    image_color_memo_entry_t table[IMAGE_COLOR_MEMO_SIZE];
+    int width;
+    int rows;
+    int64_t pixels;
+    int64_t misses;
+    bool disabled;
+    /* Followed by the per row scratch space, see image_color_memo_scratch */
+};
+
+#define IMAGE_COLOR_MEMO_ALIGN(n) (((n) + 7) & ~(size_t)7)
+
+/* Lay out the scratch space that follows the memo: for each pixel the
+   index of its missing color (or -1), the table slot of each missing color,
+   and the missing colors before and after conversion. */
+static void
+image_color_memo_scratch(gx_image_color_memo_t *memo, int spp, int spp_cm,
+                         int **ref, int **slot, byte **src, byte **des)
+{
+    byte *p = (byte *)memo + IMAGE_COLOR_MEMO_ALIGN(sizeof(*memo));
+
+    *ref = (int *)p;
+    p += IMAGE_COLOR_MEMO_ALIGN(memo->width * sizeof(int));
+    *slot = (int *)p;
+    p += IMAGE_COLOR_MEMO_ALIGN(memo->width * sizeof(int));
+    *src = p;
+    p += IMAGE_COLOR_MEMO_ALIGN((size_t)memo->width * spp);
+    *des = p;
+}
+
+static gx_image_color_memo_t *
+image_color_memo_get(gx_image_enum *penum, int width, int spp_cm)
+{
+    gx_image_color_memo_t *memo = penum->color_memo;
+    size_t size;
+
+    if (memo != NULL)
+        return (memo->disabled || memo->width < width ? NULL : memo);
+    if (width < IMAGE_COLOR_MEMO_MIN_WIDTH)
+        return NULL;
+    size = IMAGE_COLOR_MEMO_ALIGN(sizeof(*memo)) +
+           2 * IMAGE_COLOR_MEMO_ALIGN(width * sizeof(int)) +
+           IMAGE_COLOR_MEMO_ALIGN((size_t)width * penum->spp) +
+           (size_t)width * spp_cm;
+    memo = (gx_image_color_memo_t *)gs_alloc_bytes(penum->memory, size,
+                                                   "image_color_memo_get");
+    if (memo == NULL)
+        return NULL;		/* Not fatal, we just convert everything */
+    memset(memo->table, 0, sizeof(memo->table));
+    memo->width = width;
+    memo->rows = 0;
+    memo->pixels = 0;
+    memo->misses = 0;
+    memo->disabled = false;
+    penum->color_memo = memo;
+    return memo;
+}
+
+/* Convert one chunky row of 8-bit RGB or CMYK pixels, taking the colors
+   already in the memo from it and converting only the rest. */
+static int
+image_color_memo_map_row(gx_image_enum *penum, gx_image_color_memo_t *memo,
+                         gx_device *dev, const byte *psrc, int width, int spp,
+                         byte *pdes, int spp_cm)
+{
+    gsicc_bufferdesc_t input_buff_desc;
+    gsicc_bufferdesc_t output_buff_desc;
+    int *ref, *slot;
+    byte *usrc, *udes;
+    int num_missing = 0;
+    int i, k, code;
+
+    image_color_memo_scratch(memo, spp, spp_cm, &ref, &slot, &usrc, &udes);
+    for (i = 0; i < width; i++, psrc += spp) {
+        bits32 key = ((bits32)psrc[0] << 16) | ((bits32)psrc[1] << 8) | psrc[2];
+        uint h;
+        image_color_memo_entry_t *entry = NULL;
+        image_color_memo_entry_t *free_entry = NULL;
+
+        if (spp == 4)
+            key = (key << 8) | psrc[3];
+        h = (key ^ (key >> 11) ^ (key >> 22)) * 0x9E3779B1;
+        h = (h >> 20) & (IMAGE_COLOR_MEMO_SIZE - 1);
+        for (k = 0; k < IMAGE_COLOR_MEMO_PROBES; k++) {
+            image_color_memo_entry_t *e = &memo->table[(h + k) & (IMAGE_COLOR_MEMO_SIZE - 1)];
+
+            if (e->state == memo_empty) {
+                free_entry = e;
+                break;
+            }
+            if (e->key == key) {
+                entry = e;
+                break;
+            }
+        }
+        if (entry != NULL && entry->state == memo_valid) {
+            memcpy(pdes + i * spp_cm, entry->device_contone, spp_cm);
+            ref[i] = -1;
+            continue;
+        }
+        if (entry != NULL) {
+            /* Already missing earlier in this row */
+            ref[i] = entry->pending;
+            continue;
+        }
+        /* A new color. If its probe run is full, it replaces the first
+           entry in the run unless that one is still waiting for
+           conversion. */
+        if (free_entry == NULL && memo->table[h].state != memo_pending)
+            free_entry = &memo->table[h];
+        if (free_entry != NULL) {
+            free_entry->key = key;
+            free_entry->state = memo_pending;
+            free_entry->pending = num_missing;
+            slot[num_missing] = free_entry - memo->table;
+        } else
+            slot[num_missing] = -1;
+        memcpy(usrc + num_missing * spp, psrc, spp);
+        ref[i] = num_missing++;
+    }
+
+    if (num_missing > 0) {
+        gsicc_init_buffer(&input_buff_desc, spp, 1, false, false, false, 0,
+                          num_missing * spp, 1, num_missing);
+        gsicc_init_buffer(&output_buff_desc, spp_cm, 1, false, false, false, 0,
+                          num_missing * spp_cm, 1, num_missing);
+        code = (penum->icc_link->procs.map_buffer)(dev, penum->icc_link,
+                                                   &input_buff_desc,
+                                                   &output_buff_desc,
+                                                   (void *)usrc, (void *)udes);
+        if (code < 0) {
+            /* Leave nothing pending behind */
+            for (k = 0; k < num_missing; k++)
+                if (slot[k] >= 0)
+                    memo->table[slot[k]].state = memo_empty;
+            return code;
+        }
+        for (k = 0; k < num_missing; k++) {
+            if (slot[k] >= 0) {
+                image_color_memo_entry_t *e = &memo->table[slot[k]];
+
+                memcpy(e->device_contone, udes + k * spp_cm, spp_cm);
+                e->state = memo_valid;
+            }
+        }
+        for (i = 0; i < width; i++)
+            if (ref[i] >= 0)
+                memcpy(pdes + i * spp_cm, udes + ref[i] * spp_cm, spp_cm);
+    }
+
+    memo->pixels += width;
+    memo->misses += num_missing;
+    if (++memo->rows == IMAGE_COLOR_MEMO_TRIAL_ROWS &&
+        memo->misses * 4 > memo->pixels)
+        memo->disabled = true;
+    return 0;
+}
+
 /* Common code shared amongst the thresholding and non thresholding color image
    renderers */
 static int
@@ -461,6 +648,7 @@ image_color_icc_prep(gx_image_enum *penum_orig, const byte *psrc, uint w,
     byte *psrc_decode;
     const byte *planar_src;
     byte *planar_des;
+    gx_image_color_memo_t *memo;
     int j, k;
 
     code = dev_proc(dev, get_profile)(dev, &dev_profile);
@@ -574,6 +762,14 @@ image_color_icc_prep(gx_image_enum *penum_orig, const byte *psrc, uint w,
                 gs_free_object(pgs->memory, psrc_decode, "image_color_icc_prep");
                 if (code < 0)
                     return code;
+            } else if (!force_planar && (spp == 3 || spp == 4) &&
+                       spp_cm <= IMAGE_COLOR_MEMO_MAX_DES &&
+                       (memo = image_color_memo_get(penum_orig, width, spp_cm)) != NULL) {
+                /* CM only, of a row that may well repeat colors */
+                code = image_color_memo_map_row(penum_orig, memo, dev, psrc,
+                                                width, spp, *psrc_cm, spp_cm);
+                if (code < 0)
+                    return code;
             } else {
                 /* CM only. No decode */
                 code = (penum->icc_link->procs.map_buffer)(dev, penum->icc_link,
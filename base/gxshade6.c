@@ -3159,6 +3159,20 @@ mesh_triangle(patch_fill_state_t *pfs,
         if (code < 0)
             return code;
     }
+    if (!pfs->inside) {
+        /* Skip triangles which can't touch the clipping rectangle,
+           see the similar check in patch_fill. */
+        gs_fixed_rect r;
+
+        bbox_of_points(&r, &p0->p, &p1->p, &p2->p, NULL);
+        r.p.x -= INTERPATCH_PADDING;
+        r.p.y -= INTERPATCH_PADDING;
+        r.q.x += INTERPATCH_PADDING;
+        r.q.y += INTERPATCH_PADDING;
+        rect_intersect(r, pfs->rect);
+        if (r.q.x <= r.p.x || r.q.y <= r.p.y)
+            return 0;
+    }
     return mesh_triangle_rec(pfs, p0, p1, p2);
 }
 
@@ -4205,6 +4219,24 @@ patch_fill(patch_fill_state_t *pfs, const patch_curve_t curve[4],
         if (code < 0)
             goto out;
     }
+    if (!pfs->inside) {
+        /* Everything we paint for a patch, including the wedges
+           and the interpatch padding, lies within the hull of
+           its poles expanded by INTERPATCH_PADDING. A banded device
+           replays the whole mesh for each band, so most patches
+           miss the clipping rectangle entirely; skip them before
+           computing any samples. */
+        gs_fixed_rect r;
+
+        tensor_patch_bbox(&r, &p);
+        r.p.x -= INTERPATCH_PADDING;
+        r.p.y -= INTERPATCH_PADDING;
+        r.q.x += INTERPATCH_PADDING;
+        r.q.y += INTERPATCH_PADDING;
+        rect_intersect(r, pfs->rect);
+        if (r.q.x <= r.p.x || r.q.y <= r.p.y)
+            goto out;
+    }
     /* How many subdivisions of the patch in the u and v direction? */
     kv[0] = curve_samples(pfs, &p.pole[0][0], 4, pfs->fixed_flat);
     kv[1] = curve_samples(pfs, &p.pole[0][1], 4, pfs->fixed_flat);
@@ -24,7 +24,7 @@ OCRCXX = $(CXX) $(TESSINCLUDES) $(TESSCXXFLAGS) $(CCFLAGS) -DTESSERACT_IMAGEDATA
 
 # Tesseract veneer.
 $(GLGEN)tessocr.$(OBJ) : $(GLSRC)tessocr.cpp $(GLSRC)tessocr.h $(LIBOCR_MAK) \
-	$(gsmemory_h) $(gxiodev_h) $(stream_h) $(TESSDEPS)
+	$(gsmemory_h) $(gxiodev_h) $(stream_h) $(gpsync_h) $(gxsync_h) $(stdint__h) $(TESSDEPS)
 	$(OCRCXX) $(D_)OCR_SHARED=$(OCR_SHARED)$(_D) $(D_)LEPTONICA_INTERCEPT_ALLOC=1$(_D) $(I_)$(GLGEN)$(_I) $(GLO_)tessocr.$(OBJ) $(C_) $(D_)TESSDATA="$(TESSDATA)"$(_D) $(GLSRC)tessocr.cpp
 
 # 0_0 = No version.
@@ -106,6 +106,7 @@ typedef struct jpeg_decompress_data_s {
                                          * so we use a function at the interpreter level
                                          */
     void *device;                       /* The device we need to send PassThrough data to */
+    int scale_denom;                    /* Decode at 1/scale_denom of full size (1, 2, 4 or 8) */
 } jpeg_decompress_data;
 
 #define private_st_jpeg_decompress_data()	/* in zfdctd.c */\
@@ -162,4 +163,10 @@ void s_DCT_set_defaults(stream_state * st);
 void
 stream_dct_end_passthrough(jpeg_decompress_data *jddp);
 
+/* Ask a DCTDecode stream which has not yet read any data to decode at
+ * 1/denom size. Returns false (and does nothing) if s is not such a stream.
+ */
+bool
+s_DCTD_set_scale(stream *s, int denom);
+
 #endif /* sdct_INCLUDED */
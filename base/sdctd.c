@@ -22,6 +22,7 @@
 #include "gdebug.h"
 #include "gsmemory.h"
 #include "strimpl.h"
+#include "stream.h"
 #include "sdct.h"
 #include "sjpeg.h"
 
@@ -106,6 +107,7 @@ s_DCTD_init(stream_state * st)
     ss->data.decompress->skip = 0;
     ss->data.decompress->input_eod = false;
     ss->data.decompress->faked_eoi = false;
+    ss->data.decompress->scale_denom = 1;
     ss->phase = 0;
     return 0;
 }
@@ -280,6 +282,11 @@ s_DCTD_process(stream_state * st, stream_cursor_read * pr,
                 /* out_color_space will default to JCS_CMYK */
                 break;
             }
+            /* Let the IDCT do the downsampling if the client asked. */
+            if (jddp->scale_denom > 1) {
+                jddp->dinfo.scale_num = 1;
+                jddp->dinfo.scale_denom = jddp->scale_denom;
+            }
             ss->phase = 2;
             /* falls through */
         case 2:		/* start_decompress */
@@ -429,6 +436,22 @@ error_out:
     return code;
 }
 
+bool
+s_DCTD_set_scale(stream *s, int denom)
+{
+    stream_DCT_state *ss;
+    jpeg_decompress_data *jddp;
+
+    if (s == NULL || s->procs.process != s_DCTD_template.process)
+        return false;
+    ss = (stream_DCT_state *)s->state;
+    jddp = ss->data.decompress;
+    if (ss->phase != 0 || jddp->PassThrough || s->cursor.r.ptr != s->cursor.r.limit)
+        return false;
+    jddp->scale_denom = denom;
+    return true;
+}
+
 /* Stream template */
 const stream_template s_DCTD_template =
 {&st_DCT_state, s_DCTD_init, s_DCTD_process, 2000, 4000, NULL,
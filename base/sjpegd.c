@@ -51,9 +51,16 @@ int
 gs_jpeg_read_header(stream_DCT_state * st,
                     boolean require_image)
 {
+    int code;
+
     if (setjmp(find_jmp_buf(st->data.common->exit_jmpbuf)))
         return_error(gs_jpeg_log_error(st));
-    return jpeg_read_header(&st->data.decompress->dinfo, require_image);
+    code = jpeg_read_header(&st->data.decompress->dinfo, require_image);
+    /* "Fancy" upsampling in IJG 9 means scaling chroma up through the
+     * IDCT; keep the plain replicating upsampler so that full size
+     * decoding is not changed by IDCT_SCALING_SUPPORTED. */
+    st->data.decompress->dinfo.do_fancy_upsampling = FALSE;
+    return code;
 }
 
 int
@@ -21,6 +21,7 @@
 #include "gserrors.h"
 #include "gdebug.h"
 #include "strimpl.h"
+#include "stream.h"
 #include "sjpx_openjpeg.h"
 #include "gxsync.h"
 #include "assert_.h"
@@ -31,26 +32,60 @@
  * in the openjpeg library. */
 #if !defined(SHARE_JPX) || (SHARE_JPX == 0)
 static gs_memory_t *opj_memory;
+
+/* When the library is built with thread support, its worker threads
+ * allocate through opj_memory while the decode runs, and that allocator
+ * need not be thread safe (e.g. the chunk allocator used by pdfi), so
+ * allocations are serialized with a second monitor. */
+static gx_monitor_t *opj_alloc_monitor;
+
+typedef struct sjpxd_private_s {
+    gx_monitor_t *lock;         /* serializes use of the library */
+    gx_monitor_t *alloc_lock;   /* serializes allocations, or NULL */
+} sjpxd_private_t;
 #endif
 
 int sjpxd_create(gs_memory_t *mem)
 {
 #if !defined(SHARE_JPX) || (SHARE_JPX == 0)
     gs_lib_ctx_t *ctx = mem->gs_lib_ctx;
+    sjpxd_private_t *priv;
 
-    ctx->sjpxd_private = gx_monitor_label(gx_monitor_alloc(mem), "sjpxd_monitor");
-    if (ctx->sjpxd_private == NULL)
+    priv = (sjpxd_private_t *)gs_alloc_bytes_immovable(mem, sizeof(*priv), "sjpxd_create");
+    if (priv == NULL)
         return gs_error_VMerror;
-#endif
+    priv->alloc_lock = NULL;
+    priv->lock = gx_monitor_label(gx_monitor_alloc(mem), "sjpxd_monitor");
+    if (priv->lock == NULL)
+        goto fail;
+    if (opj_has_thread_support()) {
+        priv->alloc_lock = gx_monitor_label(gx_monitor_alloc(mem), "sjpxd_alloc_monitor");
+        if (priv->alloc_lock == NULL)
+            goto fail;
+    }
+    ctx->sjpxd_private = priv;
     return 0;
+
+fail:
+    gx_monitor_free(priv->lock);
+    gs_free_object(mem, priv, "sjpxd_create");
+    return gs_error_VMerror;
+#else
+    return 0;
+#endif
 }
 
 void sjpxd_destroy(gs_memory_t *mem)
 {
 #if !defined(SHARE_JPX) || (SHARE_JPX == 0)
     gs_lib_ctx_t *ctx = mem->gs_lib_ctx;
+    sjpxd_private_t *priv = (sjpxd_private_t *)ctx->sjpxd_private;
 
-    gx_monitor_free((gx_monitor_t *)ctx->sjpxd_private);
+    if (priv == NULL)
+        return;
+    gx_monitor_free(priv->lock);
+    gx_monitor_free(priv->alloc_lock);
+    gs_free_object(mem, priv, "sjpxd_destroy");
     ctx->sjpxd_private = NULL;
 #endif
 }
@@ -61,10 +96,12 @@ static int opj_lock(gs_memory_t *mem)
     int ret;
 
     gs_lib_ctx_t *ctx = mem->gs_lib_ctx;
+    sjpxd_private_t *priv = (sjpxd_private_t *)ctx->sjpxd_private;
 
-    ret = gx_monitor_enter((gx_monitor_t *)ctx->sjpxd_private);
+    ret = gx_monitor_enter(priv->lock);
     assert(opj_memory == NULL);
     opj_memory = mem->non_gc_memory;
+    opj_alloc_monitor = priv->alloc_lock;
     return ret;
 #else
     return 0;
@@ -75,10 +112,12 @@ static int opj_unlock(gs_memory_t *mem)
 {
 #if !defined(SHARE_JPX) || (SHARE_JPX == 0)
     gs_lib_ctx_t *ctx = mem->gs_lib_ctx;
+    sjpxd_private_t *priv = (sjpxd_private_t *)ctx->sjpxd_private;
 
     assert(opj_memory != NULL);
     opj_memory = NULL;
-    return gx_monitor_leave((gx_monitor_t *)ctx->sjpxd_private);
+    opj_alloc_monitor = NULL;
+    return gx_monitor_leave(priv->lock);
 #else
     return 0;
 #endif
@@ -88,6 +127,8 @@ static int opj_unlock(gs_memory_t *mem)
 /* Allocation routines that use the memory pointer given above */
 void *opj_malloc(size_t size)
 {
+    void *ptr;
+
     if (size == 0)
         return NULL;
 
@@ -96,7 +137,12 @@ void *opj_malloc(size_t size)
     if (size > (size_t) ARCH_MAX_UINT)
 	    return NULL;
 
-    return (void *)gs_alloc_bytes(opj_memory, size, "opj_malloc");
+    if (opj_alloc_monitor)
+        gx_monitor_enter(opj_alloc_monitor);
+    ptr = (void *)gs_alloc_bytes(opj_memory, size, "opj_malloc");
+    if (opj_alloc_monitor)
+        gx_monitor_leave(opj_alloc_monitor);
+    return ptr;
 }
 
 void *opj_calloc(size_t n, size_t size)
@@ -123,12 +169,21 @@ void *opj_realloc(void *ptr, size_t size)
         return NULL;
     }
 
-    return gs_resize_object(opj_memory, ptr, size, "opj_malloc");
+    if (opj_alloc_monitor)
+        gx_monitor_enter(opj_alloc_monitor);
+    ptr = gs_resize_object(opj_memory, ptr, size, "opj_malloc");
+    if (opj_alloc_monitor)
+        gx_monitor_leave(opj_alloc_monitor);
+    return ptr;
 }
 
 void opj_free(void *ptr)
 {
+    if (opj_alloc_monitor)
+        gx_monitor_enter(opj_alloc_monitor);
     gs_free_object(opj_memory, ptr, "opj_malloc");
+    if (opj_alloc_monitor)
+        gx_monitor_leave(opj_alloc_monitor);
 }
 
 static inline void * opj_aligned_malloc_n(size_t size, size_t align)
@@ -297,6 +352,10 @@ s_opjd_set_codec_format(stream_state * ss, OPJ_CODEC_FORMAT format)
         return ERRC;
     }
 
+    /* A thread count from the device overrides OPJ_NUM_THREADS */
+    if (state->NumThreads > 0 && opj_has_thread_support())
+        (void)opj_codec_set_threads(state->codec, state->NumThreads);
+
     /* open a byte stream */
     state->stream = opj_stream_default_create(OPJ_TRUE);
     if (state->stream == NULL)
@@ -385,9 +444,73 @@ ycc_to_rgb_16(unsigned char *row, unsigned long row_size)
     while (row_size);
 }
 
+/* Choose the number of resolution levels to discard for a 1/scale_denom
+ * size image. The codec's reduced image is ceil(x1 / denom) - ceil(x0 / denom)
+ * samples wide, which is the size the caller expects only when the image
+ * origin is a multiple of denom, and every component must have enough
+ * levels. Returns 0 if the codec can't do the reduction.
+ */
+static int s_opjd_reduction(stream_jpxd_state * const state)
+{
+    opj_codestream_info_v2_t *info;
+    int denom = state->scale_denom;
+    int reduce = 0;
+    OPJ_UINT32 compno;
+
+    if (denom <= 1 || state->image->x0 % denom != 0 || state->image->y0 % denom != 0)
+        return 0;
+    while ((2 << reduce) <= denom)
+        reduce++;
+
+    info = opj_get_cstr_info(state->codec);
+    if (info == NULL)
+        return 0;
+    if (info->m_default_tile_info.tccp_info == NULL)
+        reduce = 0;
+    for (compno = 0; reduce > 0 && compno < info->nbcomps; compno++)
+        if (info->m_default_tile_info.tccp_info[compno].numresolutions <= (OPJ_UINT32)reduce)
+            reduce = 0;
+    opj_destroy_cstr_info(&info);
+
+    if (reduce > 0 && !opj_set_decoded_resolution_factor(state->codec, reduce)) {
+        (void)opj_set_decoded_resolution_factor(state->codec, 0);
+        reduce = 0;
+    }
+    return reduce;
+}
+
+/* Reduce a full size image to 1/denom size by keeping every denom'th sample
+ * of every denom'th row, in place.
+ */
+static void s_opjd_decimate(opj_image_t *image, int denom)
+{
+    OPJ_UINT32 compno, x, y;
+
+    for (compno = 0; compno < image->numcomps; compno++)
+    {
+        opj_image_comp_t *comp = &image->comps[compno];
+        OPJ_UINT32 w = (comp->w + denom - 1) / denom;
+        OPJ_UINT32 h = (comp->h + denom - 1) / denom;
+
+        if (comp->data == NULL)
+            continue;
+        for (y = 0; y < h; y++)
+        {
+            const OPJ_INT32 *src = comp->data + (size_t)y * denom * comp->w;
+            OPJ_INT32 *dst = comp->data + (size_t)y * w;
+
+            for (x = 0; x < w; x++)
+                dst[x] = src[x * denom];
+        }
+        comp->w = w;
+        comp->h = h;
+    }
+}
+
 static int decode_image(stream_jpxd_state * const state)
 {
     int numprimcomp = 0, alpha_comp = -1, compno, rowbytes;
+    int reduce;
 
     /* read header */
     if (!opj_read_header(state->stream, state->codec, &(state->image)))
@@ -396,6 +519,8 @@ static int decode_image(stream_jpxd_state * const state)
     	return ERRC;
     }
 
+    reduce = s_opjd_reduction(state);
+
     /* decode the stream and fill the image structure */
     if (!opj_decode(state->codec, state->stream, state->image))
     {
@@ -403,6 +528,10 @@ static int decode_image(stream_jpxd_state * const state)
         return ERRC;
     }
 
+    /* If the codec couldn't discard resolution levels, drop samples */
+    if (state->scale_denom > 1 && reduce == 0)
+        s_opjd_decimate(state->image, state->scale_denom);
+
     /* check dimension and prec */
     if (state->image->numcomps == 0)
         return ERRC;
@@ -728,20 +857,6 @@ s_opjd_process(stream_state * ss, stream_cursor_read * pr,
             (void)opj_unlock(ss->memory);
             return code;
         }
-
-        if (state->codec == NULL) {
-            /* state->sb.size is non-zero after successful
-               accumulate_input(); 1 is probably extremely rare */
-            if (state->sb.data[0] == 0xFF && ((state->sb.size == 1) || (state->sb.data[1] == 0x4F)))
-                code = s_opjd_set_codec_format(ss, OPJ_CODEC_J2K);
-            else
-                code = s_opjd_set_codec_format(ss, OPJ_CODEC_JP2);
-            if (code < 0)
-            {
-                (void)opj_unlock(ss->memory);
-                return code;
-            }
-        }
     }
 
     if (last == 1)
@@ -757,13 +872,37 @@ s_opjd_process(stream_state * ss, stream_cursor_read * pr,
                 locked = 1;
             }
 
+            /* The codec is only created once all the data is here,
+               and torn down again as soon as the image is decoded, so
+               that any worker threads it starts (see NumThreads)
+               only run while we hold the lock. */
+            if (state->sb.data == NULL)
+            {
+                (void)opj_unlock(ss->memory);
+                return ERRC;
+            }
+            /* state->sb.size is non-zero after successful
+               accumulate_input(); 1 is probably extremely rare */
+            if (state->sb.data[0] == 0xFF && ((state->sb.size == 1) || (state->sb.data[1] == 0x4F)))
+                ret = s_opjd_set_codec_format(ss, OPJ_CODEC_J2K);
+            else
+                ret = s_opjd_set_codec_format(ss, OPJ_CODEC_JP2);
+            if (ret >= 0)
+            {
 #if OPJ_VERSION_MAJOR >= 2 && OPJ_VERSION_MINOR >= 1
-            opj_stream_set_user_data(state->stream, &(state->sb), NULL);
+                opj_stream_set_user_data(state->stream, &(state->sb), NULL);
 #else
-            opj_stream_set_user_data(state->stream, &(state->sb));
+                opj_stream_set_user_data(state->stream, &(state->sb));
 #endif
-            opj_stream_set_user_data_length(state->stream, state->sb.size);
-            ret = decode_image(state);
+                opj_stream_set_user_data_length(state->stream, state->sb.size);
+                ret = decode_image(state);
+            }
+            if (state->stream)
+                opj_stream_destroy(state->stream);
+            state->stream = NULL;
+            if (state->codec)
+                opj_destroy_codec(state->codec);
+            state->codec = NULL;
             if (ret != 0)
             {
                 (void)opj_unlock(ss->memory);
@@ -796,6 +935,8 @@ s_opjd_set_defaults(stream_state * ss) {
 
     state->alpha = false;
     state->colorspace = gs_jpx_cs_rgb;
+    state->NumThreads = 0;
+    state->scale_denom = 1;
     state->StartedPassThrough = 0;
     state->PassThrough = 0;
     state->PassThroughfn = NULL;
@@ -814,38 +955,45 @@ s_opjd_release(stream_state *ss)
         state->StartedPassThrough = 0;
         (state->PassThroughfn)(state->device, NULL, 0);
     }
-    /* empty stream or failed to accumulate */
-    if (state->codec == NULL)
-        return;
-
-    (void)opj_lock(ss->memory);
+    /* The codec and stream only outlive decode_image if it failed */
+    if (state->image || state->stream || state->codec)
+    {
+        (void)opj_lock(ss->memory);
 
-    /* free image data structure */
-    if (state->image)
-        opj_image_destroy(state->image);
+        /* free image data structure */
+        if (state->image)
+            opj_image_destroy(state->image);
+        state->image = NULL;
 
-    /* free stream */
-    if (state->stream)
-        opj_stream_destroy(state->stream);
+        /* free stream */
+        if (state->stream)
+            opj_stream_destroy(state->stream);
+        state->stream = NULL;
 
-    /* free decoder handle */
-    if (state->codec)
-	opj_destroy_codec(state->codec);
+        /* free decoder handle */
+        if (state->codec)
+            opj_destroy_codec(state->codec);
+        state->codec = NULL;
 
-    (void)opj_unlock(ss->memory);
+        (void)opj_unlock(ss->memory);
+    }
 
     /* free input buffer */
     if (state->sb.data)
         gs_free_object(state->memory->non_gc_memory, state->sb.data, "s_opjd_release(sb.data)");
+    state->sb.data = NULL;
 
     if (state->pdata)
         gs_free_object(state->memory->non_gc_memory, state->pdata, "s_opjd_release(pdata)");
+    state->pdata = NULL;
 
     if (state->sign_comps)
         gs_free_object(state->memory->non_gc_memory, state->sign_comps, "s_opjd_release(sign_comps)");
+    state->sign_comps = NULL;
 
     if (state->row_data)
         gs_free_object(state->memory->non_gc_memory, state->row_data, "s_opjd_release(row_data)");
+    state->row_data = NULL;
 }
 
 
@@ -885,6 +1033,21 @@ s_opjd_accumulate_input(stream_jpxd_state *state, stream_cursor_read * pr)
     return 0;
 }
 
+bool
+s_jpxd_set_scale(stream *s, int denom)
+{
+    stream_jpxd_state *state;
+
+    if (s == NULL || s->procs.process != s_jpxd_template.process)
+        return false;
+    state = (stream_jpxd_state *)s->state;
+    if (state->sb.fill != 0 || state->image != NULL || state->PassThrough ||
+        state->colorspace == gs_jpx_cs_indexed || s->cursor.r.ptr != s->cursor.r.limit)
+        return false;
+    state->scale_denom = denom;
+    return true;
+}
+
 /* stream template */
 const stream_template s_jpxd_template = {
     &st_jpxd_state,
@@ -59,6 +59,8 @@ typedef struct stream_jpxd_state_s
 
     gs_jpx_cs colorspace;	/* requested output colorspace */
     bool alpha; /* return opacity channel */
+    int NumThreads; /* worker threads for the codec, 0 = library default */
+    int scale_denom; /* 1, 2 or 4: decode at 1/scale_denom size */
 
     stream_block sb;
 
@@ -83,4 +85,10 @@ typedef struct stream_jpxd_state_s
 
 extern const stream_template s_jpxd_template;
 
+/* Ask a JPXDecode stream that has not read any data yet to decode at
+ * 1/denom size (denom a power of 2), so that an image of W x H samples
+ * produces (W + denom - 1) / denom x (H + denom - 1) / denom. Returns false
+ * if the stream is not a JPXDecode stream or has already started. */
+bool s_jpxd_set_scale(stream *s, int denom);
+
 #endif
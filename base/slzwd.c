@@ -38,6 +38,11 @@ struct lzw_decode_s {
     byte datum;
     byte len;			/* length of code */
     ushort prefix;		/* code to be prefixed */
+    /* The last two bytes of the string and the prefix before them, */
+    /* so that long strings can be copied two bytes per table step. */
+    /* Only valid if len >= 2. */
+    byte datum2;		/* byte before datum */
+    ushort prefix2;		/* prefix of prefix */
 };
 
 gs_private_st_simple(st_lzw_decode, lzw_decode, "lzw_decode");
@@ -259,6 +264,8 @@ s_LZWD_process(stream_state * st, stream_cursor_read * pr,
             len = prev_len + 1;
             dc_next->len = min(len, 255);
             dc_next->prefix = prev_code;
+            dc_next->datum2 = table[prev_code].datum;
+            dc_next->prefix2 = table[prev_code].prefix;
             if_debug3m('w', ss->memory, "[w]decoding anomalous 0x%x=0x%x+%c\n",
                        next_code, prev_code, dc_next->datum);
         }
@@ -301,12 +308,19 @@ s_LZWD_process(stream_state * st, stream_cursor_read * pr,
                 default:
                 {
                     byte *q1 = q += len;
+                    uint n = len;
 
+                    /* Copy two bytes per table step. */
                     c = code;
-                    do {
-                        *q1-- = (dc = &table[c])->datum;
+                    for (; n >= 2; n -= 2) {
+                        dc = &table[c];
+                        q1[0] = dc->datum;
+                        q1[-1] = dc->datum2;
+                        q1 -= 2;
+                        c = dc->prefix2;
                     }
-                    while ((c = dc->prefix) != eod);
+                    if (n)
+                        *q1-- = table[c].datum;
                     b = q1[1];
                     break;
                 }
@@ -371,6 +385,8 @@ s_LZWD_process(stream_state * st, stream_cursor_read * pr,
                     dc_next->datum = b;	/* added char of string */
                     dc_next->len = min(prev_len, 254) + 1;
                     dc_next->prefix = prev_code;
+                    dc_next->datum2 = table[prev_code].datum;
+                    dc_next->prefix2 = table[prev_code].prefix;
                     dc_next++;
                     if_debug4m('W', ss->memory, "[W]adding 0x%x=0x%x+%c(%d)\n",
                                next_code, prev_code, b, min(len, 255));
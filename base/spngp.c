@@ -19,6 +19,10 @@
 #include "strimpl.h"
 #include "spngpx.h"
 
+#ifdef HAVE_SSE2
+#include <emmintrin.h>
+#endif
+
 /* ------ PNGPredictorEncode/Decode ------ */
 
 private_st_PNGP_state();
@@ -137,6 +141,104 @@ paeth_predictor(int a, int b, int c)
 
     return (pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
 }
+
+#ifdef HAVE_SSE2
+/*
+ * SSE2 versions of the decoding loops. Up works on 16 bytes at a time.
+ * Average and Paeth depend on the pixel to the left, so they work a pixel
+ * at a time, which is only worthwhile for the common 3 and 4 byte pixels.
+ * These return the number of bytes done; the caller finishes the rest.
+ */
+static uint
+pngp_decode_up_sse2(byte *q, const byte *p, const byte *up, uint count)
+{
+    uint done = 0;
+
+    for (; count - done >= 16; done += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(p + done));
+        __m128i b = _mm_loadu_si128((const __m128i *)(up + done));
+
+        _mm_storeu_si128((__m128i *)(q + done), _mm_add_epi8(x, b));
+    }
+    return done;
+}
+
+/* Pixels are loaded 4 bytes at a time; with 3 byte pixels the top byte */
+/* is not stored, so it doesn't matter what it contains. */
+static inline __m128i
+pngp_load_pixel(const byte *p)
+{
+    return _mm_cvtsi32_si128(p[0] | (p[1] << 8) | (p[2] << 16) | ((uint)p[3] << 24));
+}
+
+static inline void
+pngp_store_pixel(byte *q, __m128i v, int bpp)
+{
+    uint x = (uint)_mm_cvtsi128_si32(v);
+
+    q[0] = (byte)x;
+    q[1] = (byte)(x >> 8);
+    q[2] = (byte)(x >> 16);
+    if (bpp == 4)
+        q[3] = (byte)(x >> 24);
+}
+
+static uint
+pngp_decode_average_sse2(byte *q, const byte *p, const byte *dprev,
+                         const byte *up, uint count, int bpp)
+{
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a = pngp_load_pixel(dprev);
+    uint done = 0;
+
+    /* Loads read 4 bytes, so stop while that is still in range. */
+    for (; count - done >= 4; done += bpp) {
+        __m128i b = pngp_load_pixel(up + done);
+        /* _mm_avg_epu8 rounds up, PNG rounds down. */
+        __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b),
+                                   _mm_and_si128(_mm_xor_si128(a, b), one));
+
+        a = _mm_add_epi8(avg, pngp_load_pixel(p + done));
+        pngp_store_pixel(q + done, a, bpp);
+    }
+    return done;
+}
+
+static uint
+pngp_decode_paeth_sse2(byte *q, const byte *p, const byte *dprev,
+                       const byte *up, const byte *upprev, uint count, int bpp)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = _mm_unpacklo_epi8(pngp_load_pixel(dprev), zero);
+    uint done = 0;
+
+    for (; count - done >= 4; done += bpp) {
+        __m128i b = _mm_unpacklo_epi8(pngp_load_pixel(up + done), zero);
+        __m128i c = _mm_unpacklo_epi8(pngp_load_pixel(upprev + done), zero);
+        /* As in paeth_predictor: pa = |b - c|, pb = |a - c|, pc = |a + b - 2c|. */
+        __m128i ac = _mm_sub_epi16(b, c);
+        __m128i bc = _mm_sub_epi16(a, c);
+        __m128i abcc = _mm_add_epi16(ac, bc);
+        __m128i pa = _mm_max_epi16(ac, _mm_sub_epi16(zero, ac));
+        __m128i pb = _mm_max_epi16(bc, _mm_sub_epi16(zero, bc));
+        __m128i pc = _mm_max_epi16(abcc, _mm_sub_epi16(zero, abcc));
+        __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        __m128i use_a = _mm_cmpeq_epi16(smallest, pa);
+        __m128i use_b = _mm_cmpeq_epi16(smallest, pb);
+        __m128i pred =
+            _mm_or_si128(_mm_and_si128(use_a, a),
+                         _mm_andnot_si128(use_a,
+                                          _mm_or_si128(_mm_and_si128(use_b, b),
+                                                       _mm_andnot_si128(use_b, c))));
+        __m128i x = _mm_unpacklo_epi8(pngp_load_pixel(p + done), zero);
+
+        a = _mm_and_si128(_mm_add_epi16(pred, x), _mm_set1_epi16(0xff));
+        pngp_store_pixel(q + done, _mm_packus_epi16(a, a), bpp);
+    }
+    return done;
+}
+#endif
+
 static void
 s_pngp_process(stream_state * st, stream_cursor_write * pw,
                const byte * dprev, stream_cursor_read * pr,
@@ -167,6 +269,13 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - *up);
             break;
         case cDecode + cUp:
+#ifdef HAVE_SSE2
+            {
+                uint done = pngp_decode_up_sse2(q, p, up, count);
+
+                q += done, up += done, p += done, count -= done;
+            }
+#endif
             for (; count; ++q, ++up, ++p, --count)
                 *q = (byte) (*p + *up);
             break;
@@ -175,6 +284,13 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - arith_rshift_1((int)*dprev + (int)*up));
             break;
         case cDecode + cAverage:
+#ifdef HAVE_SSE2
+            if (ss->bpp == 3 || ss->bpp == 4) {
+                uint done = pngp_decode_average_sse2(q, p, dprev, up, count, ss->bpp);
+
+                q += done, dprev += done, up += done, p += done, count -= done;
+            }
+#endif
             for (; count; ++q, ++dprev, ++up, ++p, --count)
                 *q = (byte) (*p + arith_rshift_1((int)*dprev + (int)*up));
             break;
@@ -183,6 +299,13 @@ s_pngp_process(stream_state * st, stream_cursor_write * pw,
                 *q = (byte) (*p - paeth_predictor(*dprev, *up, *upprev));
             break;
         case cDecode + cPaeth:
+#ifdef HAVE_SSE2
+            if (ss->bpp == 3 || ss->bpp == 4) {
+                uint done = pngp_decode_paeth_sse2(q, p, dprev, up, upprev, count, ss->bpp);
+
+                q += done, dprev += done, up += done, upprev += done, p += done, count -= done;
+            }
+#endif
             for (; count; ++q, ++dprev, ++up, ++upprev, ++p, --count)
                 *q = (byte) (*p + paeth_predictor(*dprev, *up, *upprev));
             break;
@@ -21,7 +21,10 @@
  * only makes calls when we're calling it, hence we use a leptonica_mem
  * global to store the current memory pointer in. This will clearly not
  * play nicely with multi-threaded use of Ghostscript, but that seems
- * unlikely with OCR.
+ * unlikely with OCR. (ocr_recognise_bands does run several engines at
+ * once, but they all belong to one device, and so share the memory. That
+ * memory need not be thread safe, so while the engines are running all
+ * the allocations made through it are serialized with leptonica_monitor.)
  *
  * Tesseract is trickier. For a start it uses new/delete/new[]/delete[]
  * rather than malloc free. That's OK, cos we can intercept this - see
@@ -62,6 +65,9 @@ extern "C"
 #include "tessocr.h"
 #include "gserrors.h"
 #include "gp.h"
+#include "gpsync.h"
+#include "gxsync.h"
+#include "stdint_.h"
 #include "gssprintf.h"
 #include "gxiodev.h"
 #include "stream.h"
@@ -96,9 +102,39 @@ typedef struct
 
 static gs_memory_t *leptonica_mem;
 
+/* The number of engines using leptonica_mem. */
+static int leptonica_users;
+
+/* Serializes allocations while ocr_run_bands has several engines running,
+ * NULL otherwise. */
+static gx_monitor_t *leptonica_monitor;
+
+static void *
+ocr_alloc_bytes(gs_memory_t *mem, size_t size, const char *cname)
+{
+    void *ret;
+
+    if (leptonica_monitor)
+        gx_monitor_enter(leptonica_monitor);
+    ret = gs_alloc_bytes(mem, size, cname);
+    if (leptonica_monitor)
+        gx_monitor_leave(leptonica_monitor);
+    return ret;
+}
+
+static void
+ocr_free_object(gs_memory_t *mem, void *ptr, const char *cname)
+{
+    if (leptonica_monitor)
+        gx_monitor_enter(leptonica_monitor);
+    gs_free_object(mem, ptr, cname);
+    if (leptonica_monitor)
+        gx_monitor_leave(leptonica_monitor);
+}
+
 void *leptonica_malloc(size_t size)
 {
-    void *ret = gs_alloc_bytes(leptonica_mem, size, "leptonica_malloc");
+    void *ret = ocr_alloc_bytes(leptonica_mem, size, "leptonica_malloc");
 #ifdef DEBUG_ALLOCS
     printf("%d LEPTONICA_MALLOC(%p) %d -> %p\n", event++, leptonica_mem, (int)size, ret);
     fflush(stdout);
@@ -112,7 +148,7 @@ void leptonica_free(void *ptr)
     printf("%d LEPTONICA_FREE(%p) %p\n", event++, leptonica_mem, ptr);
     fflush(stdout);
 #endif
-    gs_free_object(leptonica_mem, ptr, "leptonica_free");
+    ocr_free_object(leptonica_mem, ptr, "leptonica_free");
 }
 
 void *leptonica_calloc(size_t numelm, size_t elemsize)
@@ -390,14 +426,17 @@ ocr_init_api(gs_memory_t *mem, const char *language, int engine, void **state)
     }
 
     *state = (void *)wrapped;
+    leptonica_users++;
 
     return 0;
 fail:
     if (wrapped->api) {
         delete wrapped->api;
     }
-    leptonica_mem = NULL;
-    setPixMemoryManager(malloc, free);
+    if (leptonica_users == 0) {
+        leptonica_mem = NULL;
+        setPixMemoryManager(malloc, free);
+    }
     gs_free_object(wrapped->mem, wrapped, "ocr_init_api");
     return_error(code);
 }
@@ -415,8 +454,10 @@ ocr_fin_api(gs_memory_t *mem, void *api_)
         delete wrapped->api;
     }
     gs_free_object(wrapped->mem, wrapped, "ocr_fin_api");
-    leptonica_mem = NULL;
-    setPixMemoryManager(malloc, free);
+    if (--leptonica_users == 0) {
+        leptonica_mem = NULL;
+        setPixMemoryManager(malloc, free);
+    }
 }
 
 static Pix *
@@ -516,6 +557,64 @@ int ocr_image_to_utf8(void *api,
                             restore, 0, 0, out);
 }
 
+/* Call back for every symbol in the results of Recognize(). */
+static int
+ocr_iterate(tesseract::TessBaseAPI *api,
+            int (*callback)(void *, const char *, const int *, const int *, const int *, int),
+            void *arg)
+{
+    tesseract::ResultIterator *res_it = api->GetIterator();
+    int code = 0;
+    int word_bbox[4];
+    int char_bbox[4];
+    int line_bbox[4];
+    bool bold, italic, underlined, monospace, serif, smallcaps;
+    int pointsize, font_id;
+    const char* font_name;
+
+    while (!res_it->Empty(tesseract::RIL_BLOCK)) {
+        if (res_it->Empty(tesseract::RIL_WORD)) {
+            res_it->Next(tesseract::RIL_WORD);
+            continue;
+        }
+
+        res_it->BoundingBox(tesseract::RIL_TEXTLINE,
+                            line_bbox, line_bbox+1,
+                            line_bbox+2, line_bbox+3);
+        res_it->BoundingBox(tesseract::RIL_WORD,
+                            word_bbox, word_bbox+1,
+                            word_bbox+2, word_bbox+3);
+        font_name = res_it->WordFontAttributes(&bold,
+                                               &italic,
+                                               &underlined,
+                                               &monospace,
+                                               &serif,
+                                               &smallcaps,
+                                               &pointsize,
+                                               &font_id);
+        (void)font_name;
+        do {
+            const char *graph = res_it->GetUTF8Text(tesseract::RIL_SYMBOL);
+            if (graph && graph[0] != 0) {
+                res_it->BoundingBox(tesseract::RIL_SYMBOL,
+                                    char_bbox, char_bbox+1,
+                                    char_bbox+2, char_bbox+3);
+                code = callback(arg, graph, line_bbox, word_bbox, char_bbox, pointsize);
+                if (code < 0)
+                {
+                    delete res_it;
+                    return code;
+                }
+            }
+            res_it->Next(tesseract::RIL_SYMBOL);
+         } while (!res_it->Empty(tesseract::RIL_BLOCK) &&
+                  !res_it->IsAtBeginningOf(tesseract::RIL_WORD));
+    }
+    delete res_it;
+
+    return code;
+}
+
 int
 ocr_recognise(void *api_, int w, int h, void *data,
               int xres, int yres,
@@ -525,12 +624,6 @@ ocr_recognise(void *api_, int w, int h, void *data,
     wrapped_api *wrapped = (wrapped_api *)api_;
     Pix *image;
     int code;
-    int word_bbox[4];
-    int char_bbox[4];
-    int line_bbox[4];
-    bool bold, italic, underlined, monospace, serif, smallcaps;
-    int pointsize, font_id;
-    const char* font_name;
 
     if (wrapped == NULL || wrapped->api == NULL)
         return 0;
@@ -542,51 +635,384 @@ ocr_recognise(void *api_, int w, int h, void *data,
     code = wrapped->api->Recognize(NULL);
     if (code >= 0) {
         /* Bingo! */
-        tesseract::ResultIterator *res_it = wrapped->api->GetIterator();
+        code = ocr_iterate(wrapped->api, callback, arg);
+    }
 
-        while (!res_it->Empty(tesseract::RIL_BLOCK)) {
-            if (res_it->Empty(tesseract::RIL_WORD)) {
-                res_it->Next(tesseract::RIL_WORD);
-                continue;
+    ocr_clear_image(image);
+
+    return code;
+}
+
+/* A band of a page, recognised by one engine for ocr_recognise_bands or
+ * ocr_image_to_utf8_bands. */
+typedef struct
+{
+    char graph[16];
+    int line_bbox[4];
+    int word_bbox[4];
+    int char_bbox[4];
+    int pointsize;
+} ocr_band_char;
+
+typedef struct
+{
+    wrapped_api *wrapped;
+    Pix *image;
+    int w;
+    /* The band owns the rows from y0 to y1, but the engine is given the
+     * rows from ry0 to ry1, which overlap its neighbours. */
+    int y0, y1;
+    int ry0, ry1;
+    int utf8;
+    /* Results: the text (if utf8), or the symbols found. */
+    char *text;
+    ocr_band_char *chars;
+    int num_chars;
+    int max_chars;
+    int code;
+} ocr_band;
+
+/* The engine for each band also sees this much of the bands either side
+ * of it (as a fraction of an inch), so that the text at a seam is seen
+ * whole by both engines, with the same context as when it is recognised
+ * in one go. */
+#define OCR_BAND_OVERLAP_DIV 2
+
+/* Does a band own a result with the given bbox? Results from the overlaps
+ * are found by both bands, so each is only kept by the band that holds
+ * its middle row. */
+static int
+ocr_band_owns(const ocr_band *band, const int *bbox)
+{
+    int mid = (bbox[1] + bbox[3]) / 2;
+
+    return mid >= band->y0 && mid < band->y1;
+}
+
+/* Record a symbol for ocr_recognise_bands to pass on later. */
+static int
+ocr_band_record(void *arg, const char *graph,
+                const int *line_bbox, const int *word_bbox,
+                const int *char_bbox, int pointsize)
+{
+    ocr_band *band = (ocr_band *)arg;
+    ocr_band_char *c;
+
+    /* Keep the symbols of a word together, by deciding on the word. */
+    if (!ocr_band_owns(band, word_bbox))
+        return 0;
+
+    if (band->num_chars == band->max_chars) {
+        int new_max = band->max_chars ? band->max_chars * 2 : 256;
+        ocr_band_char *new_chars;
+
+        new_chars = (ocr_band_char *)ocr_alloc_bytes(band->wrapped->mem,
+                                             sizeof(ocr_band_char) * new_max,
+                                             "ocr_band_record");
+        if (new_chars == NULL)
+            return_error(gs_error_VMerror);
+        if (band->num_chars)
+            memcpy(new_chars, band->chars, sizeof(ocr_band_char) * band->num_chars);
+        ocr_free_object(band->wrapped->mem, band->chars, "ocr_band_record");
+        band->chars = new_chars;
+        band->max_chars = new_max;
+    }
+    c = &band->chars[band->num_chars++];
+    strncpy(c->graph, graph, sizeof(c->graph) - 1);
+    c->graph[sizeof(c->graph) - 1] = 0;
+    memcpy(c->line_bbox, line_bbox, sizeof(c->line_bbox));
+    memcpy(c->word_bbox, word_bbox, sizeof(c->word_bbox));
+    memcpy(c->char_bbox, char_bbox, sizeof(c->char_bbox));
+    c->pointsize = pointsize;
+
+    return 0;
+}
+
+/* Collect the text of the lines a band owns, as GetUTF8Text would give it
+ * for the whole page. */
+static int
+ocr_band_text(ocr_band *band, tesseract::TessBaseAPI *api)
+{
+    tesseract::ResultIterator *res_it = api->GetIterator();
+    size_t len = 0, max_len = 0;
+    int line_bbox[4];
+    int code = 0;
+
+    if (res_it == NULL)
+        return 0;
+    if (!res_it->Empty(tesseract::RIL_TEXTLINE)) do {
+        char *line;
+        size_t line_len;
+
+        res_it->BoundingBox(tesseract::RIL_TEXTLINE,
+                            line_bbox, line_bbox+1,
+                            line_bbox+2, line_bbox+3);
+        if (!ocr_band_owns(band, line_bbox))
+            continue;
+        /* This includes the line's separators, and those of its paragraph
+         * if it is the last line of one. */
+        line = res_it->GetUTF8Text(tesseract::RIL_TEXTLINE);
+        if (line == NULL)
+            continue;
+        line_len = strlen(line);
+        if (len + line_len + 1 > max_len) {
+            size_t new_max = (len + line_len + 1) * 2;
+            char *new_text = (char *)ocr_alloc_bytes(band->wrapped->mem, new_max,
+                                                     "ocr_band_text");
+
+            if (new_text == NULL) {
+                delete [] line;
+                code = gs_note_error(gs_error_VMerror);
+                break;
             }
+            if (len)
+                memcpy(new_text, band->text, len);
+            ocr_free_object(band->wrapped->mem, band->text, "ocr_band_text");
+            band->text = new_text;
+            max_len = new_max;
+        }
+        memcpy(band->text + len, line, line_len + 1);
+        len += line_len;
+        delete [] line;
+    } while (res_it->Next(tesseract::RIL_TEXTLINE));
+    delete res_it;
 
-            res_it->BoundingBox(tesseract::RIL_TEXTLINE,
-                                line_bbox, line_bbox+1,
-                                line_bbox+2, line_bbox+3);
-            res_it->BoundingBox(tesseract::RIL_WORD,
-                                word_bbox, word_bbox+1,
-                                word_bbox+2, word_bbox+3);
-            font_name = res_it->WordFontAttributes(&bold,
-                                                   &italic,
-                                                   &underlined,
-                                                   &monospace,
-                                                   &serif,
-                                                   &smallcaps,
-                                                   &pointsize,
-                                                   &font_id);
-            (void)font_name;
-            do {
-                const char *graph = res_it->GetUTF8Text(tesseract::RIL_SYMBOL);
-                if (graph && graph[0] != 0) {
-                    res_it->BoundingBox(tesseract::RIL_SYMBOL,
-                                        char_bbox, char_bbox+1,
-                                        char_bbox+2, char_bbox+3);
-                    code = callback(arg, graph, line_bbox, word_bbox, char_bbox, pointsize);
-                    if (code < 0)
-                    {
-                        delete res_it;
-                        return code;
-                    }
-                }
-                res_it->Next(tesseract::RIL_SYMBOL);
-             } while (!res_it->Empty(tesseract::RIL_BLOCK) &&
-                      !res_it->IsAtBeginningOf(tesseract::RIL_WORD));
+    return code;
+}
+
+/* Recognise one band. Runs in a thread of its own, apart from the first
+ * band (or any band we couldn't start a thread for). */
+static void
+ocr_band_thread(void *arg)
+{
+    ocr_band *band = (ocr_band *)arg;
+    tesseract::TessBaseAPI *api = band->wrapped->api;
+
+    api->SetImage(band->image);
+    /* Results are still given in the coordinates of the whole page. */
+    api->SetRectangle(0, band->ry0, band->w, band->ry1 - band->ry0);
+    band->code = api->Recognize(NULL);
+    if (band->code < 0)
+        return;
+    if (band->utf8)
+        band->code = ocr_band_text(band, api);
+    else
+        band->code = ocr_iterate(api, ocr_band_record, band);
+}
+
+/* Is a row of an 8 bit leptonica image free of anything that might be
+ * text? */
+static int
+ocr_row_is_blank(const l_uint32 *data, int wpl, int y)
+{
+    const unsigned char *p = (const unsigned char *)(data + (size_t)wpl * y);
+    int i;
+
+    for (i = 0; i < wpl * 4; i++)
+        if (p[i] < 0x80)
+            return 0;
+    return 1;
+}
+
+/* Split a page of h rows into at most n bands of similar heights, cutting
+ * only at blank rows, so that we don't cut through a line of text. Band i
+ * runs from row cuts[i] to row cuts[i+1]. Returns the number of bands. */
+static int
+ocr_split_bands(const l_uint32 *data, int wpl, int h, int n, int *cuts)
+{
+    int slack = h / (2 * n);
+    int count = 0;
+    int k, d, y;
+
+    cuts[0] = 0;
+    for (k = 1; k < n; k++) {
+        int ideal = (int)((int64_t)h * k / n);
+
+        y = -1;
+        for (d = 0; d <= slack && y < 0; d++) {
+            if (ideal - d > cuts[count] && ocr_row_is_blank(data, wpl, ideal - d))
+                y = ideal - d;
+            else if (ideal + d < h && ocr_row_is_blank(data, wpl, ideal + d))
+                y = ideal + d;
         }
-        delete res_it;
-        code = code;
+        if (y > cuts[count])
+            cuts[++count] = y;
     }
+    cuts[++count] = h;
 
-    ocr_clear_image(image);
+    return count;
+}
+
+/* Split an 8 bit leptonica image into bands, and recognise them, one band
+ * per engine, in parallel. The split depends only on the image and on the
+ * number of engines, so the results are the same from run to run. Each
+ * engine sees a little more than its band, and only the results whose
+ * middle lies inside the band are kept, so that nothing at a seam is lost
+ * or found twice. */
+static int
+ocr_run_bands(void **states, int num_states, int w, int h, void *data,
+              int xres, int yres, int utf8, ocr_band *bands, int *num_bands)
+{
+    gp_thread_id threads[OCR_MAX_THREADS];
+    int cuts[OCR_MAX_THREADS + 1];
+    int i, n, overlap;
+
+    if (num_states > OCR_MAX_THREADS)
+        num_states = OCR_MAX_THREADS;
+    memset(bands, 0, sizeof(ocr_band) * num_states);
+    *num_bands = 0;
+
+    /* Each engine gets a Pix of its own (Tesseract takes references to
+     * it), but they all share the data. */
+    for (i = 0; i < num_states; i++) {
+        bands[i].image = pixCreateHeader(w, h, 8);
+        if (bands[i].image == NULL) {
+            while (i-- > 0)
+                ocr_clear_image(bands[i].image);
+            return_error(gs_error_VMerror);
+        }
+        pixSetData(bands[i].image, (l_uint32 *)data);
+        pixSetXRes(bands[i].image, xres);
+        pixSetYRes(bands[i].image, yres);
+    }
+    pixSetPadBits(bands[0].image, 1);
+
+    n = ocr_split_bands(pixGetData(bands[0].image), pixGetWpl(bands[0].image),
+                        h, num_states, cuts);
+    overlap = (yres > 0 ? yres : 300) / OCR_BAND_OVERLAP_DIV;
+    for (i = 0; i < n; i++) {
+        bands[i].wrapped = (wrapped_api *)states[i];
+        bands[i].w = w;
+        bands[i].y0 = cuts[i];
+        bands[i].y1 = cuts[i+1];
+        bands[i].ry0 = max(bands[i].y0 - overlap, 0);
+        bands[i].ry1 = min(bands[i].y1 + overlap, h);
+        bands[i].utf8 = utf8;
+    }
+
+    /* The engines share one allocator, which may not be thread safe. If we
+     * can't get a monitor to serialize it, recognise the bands one by one. */
+    if (n > 1)
+        leptonica_monitor = gx_monitor_label(gx_monitor_alloc(bands[0].wrapped->mem),
+                                             "ocr_alloc_monitor");
+    for (i = 1; i < n; i++) {
+        if (leptonica_monitor == NULL ||
+            gp_thread_start(ocr_band_thread, &bands[i], &threads[i]) < 0) {
+            threads[i] = NULL;
+            ocr_band_thread(&bands[i]);
+        }
+    }
+    ocr_band_thread(&bands[0]);
+    for (i = 1; i < n; i++) {
+        if (threads[i] != NULL)
+            gp_thread_finish(threads[i]);
+    }
+    if (leptonica_monitor != NULL) {
+        gx_monitor_t *mon = leptonica_monitor;
+
+        leptonica_monitor = NULL;
+        gx_monitor_free(mon);
+    }
+
+    for (i = 0; i < num_states; i++)
+        ocr_clear_image(bands[i].image);
+    *num_bands = n;
+
+    return 0;
+}
+
+int
+ocr_recognise_bands(void **states, int num_states,
+                    int w, int h, void *data,
+                    int xres, int yres,
+                    int (*callback)(void *, const char *, const int *, const int *, const int *, int),
+                    void *arg)
+{
+    ocr_band bands[OCR_MAX_THREADS];
+    int i, j, n, code;
+
+    if (num_states <= 1)
+        return ocr_recognise(states[0], w, h, data, xres, yres, callback, arg);
+
+    for (i = 0; i < num_states; i++) {
+        wrapped_api *wrapped = (wrapped_api *)states[i];
+
+        if (wrapped == NULL || wrapped->api == NULL)
+            return 0;
+    }
+
+    code = ocr_run_bands(states, num_states, w, h, data, xres, yres, 0,
+                         bands, &n);
+    if (code < 0)
+        return code;
+
+    /* Hand on the results in page order. */
+    for (i = 0; i < n; i++) {
+        if (code >= 0)
+            code = bands[i].code;
+        for (j = 0; code >= 0 && j < bands[i].num_chars; j++) {
+            ocr_band_char *c = &bands[i].chars[j];
+
+            code = callback(arg, c->graph, c->line_bbox, c->word_bbox,
+                            c->char_bbox, c->pointsize);
+        }
+        gs_free_object(bands[i].wrapped->mem, bands[i].chars, "ocr_recognise_bands");
+    }
+
+    return code;
+}
+
+int
+ocr_image_to_utf8_bands(void **states, int num_states,
+                        int w, int h, int bpp, int raster,
+                        int xres, int yres, void *data, int restore,
+                        char **out)
+{
+    ocr_band bands[OCR_MAX_THREADS];
+    wrapped_api *wrapped = (wrapped_api *)states[0];
+    size_t len = 0;
+    int i, n, code;
+
+    if (num_states <= 1)
+        return ocr_image_to_utf8(states[0], w, h, bpp, raster, xres, yres,
+                                 data, restore, out);
+
+    *out = NULL;
+
+    if (bpp == 8)
+        w = convert2pix((l_uint32 *)data, w, h, raster);
+
+    code = ocr_run_bands(states, num_states, w, h, data, xres, yres, 1,
+                         bands, &n);
+
+    /* Convert the image back. */
+    if (restore && bpp == 8)
+        convert2pix((l_uint32 *)data, w, h, raster);
+
+    if (code < 0)
+        return code;
+
+    for (i = 0; i < n; i++) {
+        if (code >= 0)
+            code = bands[i].code;
+        if (bands[i].text)
+            len += strlen(bands[i].text);
+    }
+    if (code >= 0) {
+        *out = (char *)(void *)gs_alloc_bytes(wrapped->mem, len + 1, "ocr_to_utf8");
+        if (*out) {
+            len = 0;
+            for (i = 0; i < n; i++) {
+                if (bands[i].text) {
+                    strcpy(*out + len, bands[i].text);
+                    len += strlen(bands[i].text);
+                }
+            }
+            (*out)[len] = 0;
+        }
+    }
+    for (i = 0; i < n; i++)
+        gs_free_object(bands[i].wrapped->mem, bands[i].text, "ocr_image_to_utf8_bands");
 
     return code;
 }
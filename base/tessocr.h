@@ -21,6 +21,10 @@
 
 #include "gsmemory.h"
 
+/* The most engines that ocr_recognise_bands and ocr_image_to_utf8_bands
+ * will use at once. */
+#define OCR_MAX_THREADS 16
+
 enum
 {
     OCR_ENGINE_DEFAULT = 0,
@@ -46,6 +50,20 @@ int ocr_recognise(void *state,
                   int (*callback)(void *, const char *, const int *, const int *, const int *, int),
                   void *arg);
 
+/* As ocr_recognise, but with num_states engines (from ocr_init_api) at
+ * once. The page is split into horizontal bands between lines of text, and
+ * each engine recognises a band in a thread of its own. The callbacks are
+ * made afterwards, from the calling thread, band by band down the page. */
+int ocr_recognise_bands(void **states,
+                        int    num_states,
+                        int    w,
+                        int    h,
+                        void  *data,
+                        int    xres,
+                        int    yres,
+                        int (*callback)(void *, const char *, const int *, const int *, const int *, int),
+                        void  *arg);
+
 int ocr_bitmap_to_unicodes(void *state,
                      const void *data,
 			   int   data_x,
@@ -68,6 +86,20 @@ int ocr_image_to_utf8(void  *state,
 		      int    restore_data,
                       char **out);
 
+/* As ocr_image_to_utf8, but split into bands as for ocr_recognise_bands.
+ * The text of the bands is concatenated. */
+int ocr_image_to_utf8_bands(void **states,
+                            int    num_states,
+                            int    w,
+                            int    h,
+                            int    bpp,
+                            int    raster,
+                            int    xres,
+                            int    yres,
+                            void  *data,
+                            int    restore_data,
+                            char **out);
+
 int ocr_image_to_hocr(void  *state,
                       int    w,
 		      int    h,
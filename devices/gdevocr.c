@@ -40,14 +40,19 @@ static dev_proc_close_device(ocr_close);
 static dev_proc_close_device(hocr_close);
 
 typedef struct gx_device_ocr_s gx_device_ocr;
+
+static void ocr_close_apis(gx_device_ocr *dev);
 struct gx_device_ocr_s {
     gx_device_common;
     gx_prn_device_common;
     gx_downscaler_params downscale;
     char language[1024];
     int engine;
+    int threads;                /* OCRThreads */
     int page_count;
-    void *api;
+    /* The OCR engines, one per thread. */
+    int num_apis;
+    void **api;
 };
 
 /* 8-bit gray bitmap -> UTF8 OCRd text */
@@ -120,24 +125,50 @@ static int
 ocr_open(gx_device *pdev)
 {
     gx_device_ocr *dev = (gx_device_ocr *)pdev;
-    int code;
+    int code, i, num_apis;
 
     dev->page_count = 0;
 
-    code = ocr_init_api(dev->memory->non_gc_memory,
-                        dev->language, dev->engine, &dev->api);
-    if (code < 0)
-        return code;
+    /* One engine per thread, each loaded with the language data once, and
+     * used for every page. hOCR pages can't be put together from bands, so
+     * that only ever needs one. */
+    num_apis = dev->threads > 1 && dev_proc(dev, close_device) != hocr_close ? dev->threads : 1;
+    dev->num_apis = 0;
+    dev->api = (void **)gs_alloc_bytes(dev->memory->non_gc_memory,
+                                       sizeof(void *) * num_apis, "ocr_open");
+    if (dev->api == NULL)
+        return_error(gs_error_VMerror);
+    for (i = 0; i < num_apis; i++) {
+        code = ocr_init_api(dev->memory->non_gc_memory,
+                            dev->language, dev->engine, &dev->api[i]);
+        if (code < 0) {
+            ocr_close_apis(dev);
+            return code;
+        }
+        dev->num_apis++;
+    }
 
     return gdev_prn_open(pdev);
 }
 
+static void
+ocr_close_apis(gx_device_ocr *dev)
+{
+    int i;
+
+    for (i = 0; i < dev->num_apis; i++)
+        ocr_fin_api(dev->memory->non_gc_memory, dev->api[i]);
+    gs_free_object(dev->memory->non_gc_memory, dev->api, "ocr_close");
+    dev->api = NULL;
+    dev->num_apis = 0;
+}
+
 static int
 ocr_close(gx_device *pdev)
 {
     gx_device_ocr *dev = (gx_device_ocr *)pdev;
 
-    ocr_fin_api(dev->memory->non_gc_memory, dev->api);
+    ocr_close_apis(dev);
 
     return gdev_prn_close(pdev);
 }
@@ -176,6 +207,9 @@ ocr_get_params(gx_device * dev, gs_param_list * plist)
     if ((code = param_write_int(plist, "OCREngine", &pdev->engine)) < 0)
         ecode = code;
 
+    if ((code = param_write_int(plist, "OCRThreads", &pdev->threads)) < 0)
+        ecode = code;
+
     if ((code = gx_downscaler_write_params(plist, &pdev->downscale,
                                            GX_DOWNSCALER_PARAMS_MFS)) < 0)
         ecode = code;
@@ -195,7 +229,7 @@ ocr_put_params(gx_device *dev, gs_param_list *plist)
     gs_param_string langstr;
     const char *param_name;
     size_t len;
-    int engine;
+    int engine, threads;
 
     switch (code = param_read_string(plist, (param_name = "OCRLanguage"), &langstr)) {
         case 0:
@@ -229,6 +263,21 @@ ocr_put_params(gx_device *dev, gs_param_list *plist)
             param_signal_error(plist, param_name, ecode);
     }
 
+    switch (code = param_read_int(plist, (param_name = "OCRThreads"), &threads)) {
+        case 0:
+            if (threads < 0 || threads > OCR_MAX_THREADS) {
+                ecode = gs_note_error(gs_error_rangecheck);
+                param_signal_error(plist, param_name, ecode);
+            } else
+                pdev->threads = threads;
+            break;
+        case 1:
+            break;
+        default:
+            ecode = code;
+            param_signal_error(plist, param_name, ecode);
+    }
+
     code = gx_downscaler_read_params(plist, &pdev->downscale,
                                      GX_DOWNSCALER_PARAMS_MFS);
     if (code < 0)
@@ -285,7 +334,7 @@ do_ocr_print_page(gx_device_ocr * pdev, gp_file * file, int hocr)
         goto done;
 
     if (hocr)
-        code = ocr_image_to_hocr(pdev->api,
+        code = ocr_image_to_hocr(pdev->api[0],
                                  width, height,
                                  8, raster,
                                  (int)pdev->HWResolution[0],
@@ -293,12 +342,12 @@ do_ocr_print_page(gx_device_ocr * pdev, gp_file * file, int hocr)
                                  data, 0, pdev->page_count,
                                  &out);
     else
-        code = ocr_image_to_utf8(pdev->api,
-                                 width, height,
-                                 8, raster,
-                                 (int)pdev->HWResolution[0],
-                                 (int)pdev->HWResolution[1],
-                                 data, 0, &out);
+        code = ocr_image_to_utf8_bands(pdev->api, pdev->num_apis,
+                                       width, height,
+                                       8, raster,
+                                       (int)pdev->HWResolution[0],
+                                       (int)pdev->HWResolution[1],
+                                       data, 0, &out);
     if (code < 0)
         goto done;
     if (out)
@@ -1285,7 +1285,17 @@ PCLm_open(gx_device *pdev)
         pdev = pdev->child;
 
     ppdev = (gx_device_pdf_image *)pdev;
-    memset(&ppdev->ocr, 0, sizeof(ppdev->ocr));
+    {
+        /* Clear the OCR state, but keep the parameters. */
+        char language[sizeof(ppdev->ocr.language)];
+        int engine = ppdev->ocr.engine, threads = ppdev->ocr.threads;
+
+        memcpy(language, ppdev->ocr.language, sizeof(language));
+        memset(&ppdev->ocr, 0, sizeof(ppdev->ocr));
+        memcpy(ppdev->ocr.language, language, sizeof(language));
+        ppdev->ocr.engine = engine;
+        ppdev->ocr.threads = threads;
+    }
     ppdev->file = NULL;
     ppdev->Pages = NULL;
     ppdev->NumPages = 0;
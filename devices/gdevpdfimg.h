@@ -81,7 +81,10 @@ typedef struct gx_device_pdf_image_s {
     struct {
         char language[1024];
         int engine;
-        void *state;
+        int threads;            /* OCRThreads */
+        /* The OCR engines, one per thread. */
+        int num_states;
+        void **states;
 
         /* Number of "file level" objects - i.e. the number of objects
          * required to define the font. */
@@ -46,7 +46,7 @@ pdfocr_put_some_params(gx_device * dev, gs_param_list * plist)
     gs_param_string langstr;
     const char *param_name;
     size_t len;
-    int engine;
+    int engine, threads;
 
     switch (code = param_read_string(plist, (param_name = "OCRLanguage"), &langstr)) {
         case 0:
@@ -80,7 +80,22 @@ pdfocr_put_some_params(gx_device * dev, gs_param_list * plist)
             param_signal_error(plist, param_name, ecode);
     }
 
-    return code;
+    switch (code = param_read_int(plist, (param_name = "OCRThreads"), &threads)) {
+        case 0:
+            if (threads < 0 || threads > OCR_MAX_THREADS) {
+                ecode = gs_note_error(gs_error_rangecheck);
+                param_signal_error(plist, param_name, ecode);
+            } else
+                pdf_dev->ocr.threads = threads;
+            break;
+        case 1:
+            break;
+        default:
+            ecode = code;
+            param_signal_error(plist, param_name, ecode);
+    }
+
+    return (ecode < 0 ? ecode : code);
 }
 
 static int
@@ -124,6 +139,9 @@ pdfocr_get_some_params(gx_device * dev, gs_param_list * plist)
     if ((code = param_write_int(plist, "OCREngine", &pdf_dev->ocr.engine)) < 0)
         ecode = code;
 
+    if ((code = param_write_int(plist, "OCRThreads", &pdf_dev->ocr.threads)) < 0)
+        ecode = code;
+
     return ecode;
 }
 
@@ -422,6 +440,8 @@ static int
 ocr_file_init(gx_device_pdf_image *dev)
 {
     const char *language = dev->ocr.language;
+    int i, num_states, code;
+
     if (language == NULL || language[0] == 0)
         language = "eng";
 
@@ -442,7 +462,22 @@ ocr_file_init(gx_device_pdf_image *dev)
     stream_write(dev->strm, funky_font6a, sizeof(funky_font6a));
     stream_write(dev->strm, funky_font6b, sizeof(funky_font6b)-1);
 
-    return ocr_init_api(dev->memory->non_gc_memory, language, dev->ocr.engine, &dev->ocr.state);
+    /* One engine per thread, each loaded with the language data once, and
+     * used for every page. */
+    num_states = dev->ocr.threads > 1 ? dev->ocr.threads : 1;
+    dev->ocr.states = (void **)gs_alloc_bytes(dev->memory->non_gc_memory,
+                                              sizeof(void *) * num_states,
+                                              "ocr_file_init");
+    if (dev->ocr.states == NULL)
+        return_error(gs_error_VMerror);
+    for (i = 0; i < num_states; i++) {
+        code = ocr_init_api(dev->memory->non_gc_memory, language, dev->ocr.engine, &dev->ocr.states[i]);
+        if (code < 0)
+            return code;
+        dev->ocr.num_states++;
+    }
+
+    return 0;
 }
 
 static void
@@ -688,14 +723,15 @@ ocr_end_page(gx_device_pdf_image *dev)
     dev->ocr.word_len = 0;
     dev->ocr.word_max = 0;
     dev->ocr.word_chars = NULL;
-    ocr_recognise(dev->ocr.state,
-                  dev->ocr.w,
-                  dev->ocr.h,
-                  dev->ocr.data,
-                  dev->ocr.xres,
-                  dev->ocr.yres,
-                  ocr_callback,
-                  dev);
+    ocr_recognise_bands(dev->ocr.states,
+                        dev->ocr.num_states,
+                        dev->ocr.w,
+                        dev->ocr.h,
+                        dev->ocr.data,
+                        dev->ocr.xres,
+                        dev->ocr.yres,
+                        ocr_callback,
+                        dev);
     if (dev->ocr.word_len)
         flush_word(dev);
     stream_puts(dev->strm, "\nET");
@@ -746,7 +782,7 @@ static int
 pdf_ocr_close(gx_device *pdev)
 {
     gx_device_pdf_image *pdf_dev;
-    int code;
+    int code, i;
 
     code = pdf_image_close(pdev);
     if (code < 0)
@@ -757,8 +793,11 @@ pdf_ocr_close(gx_device *pdev)
         pdev = pdev->child;
     pdf_dev = (gx_device_pdf_image *)pdev;
 
-    ocr_fin_api(pdf_dev->memory, pdf_dev->ocr.state);
-    pdf_dev->ocr.state = NULL;
+    for (i = 0; i < pdf_dev->ocr.num_states; i++)
+        ocr_fin_api(pdf_dev->memory, pdf_dev->ocr.states[i]);
+    gs_free_object(pdf_dev->memory->non_gc_memory, pdf_dev->ocr.states, "pdf_ocr_close");
+    pdf_dev->ocr.states = NULL;
+    pdf_dev->ocr.num_states = 0;
 
     return code;
 }
@@ -1613,6 +1613,12 @@ psd_prn_close(gx_device *dev)
  * SeparationOrder data.
  */
 
+/* The planes are written one after another, so rather than seeking to
+ * each plane for every line, we gather a strip of lines of each plane,
+ * and write each plane's part of the strip in one go. */
+#define PSD_STRIP_BYTES (4 << 20)   /* aim for strips about this big */
+#define PSD_MAX_STRIP_ROWS 256
+
 static int
 psd_write_image_data(psd_write_ctx *xc, gx_device_printer *pdev)
 {
@@ -1632,6 +1638,9 @@ psd_write_image_data(psd_write_ctx *xc, gx_device_printer *pdev)
     gx_downscaler_t ds = { NULL };
     int octets_per_component = bpc >> 3;
     int octets_per_line = xc->width * octets_per_component;
+    size_t plane_strip_size;
+    gs_offset_t image_start;
+    int strip_rows, rows, r;
 
     /* Return planar data */
     params.options = (GB_RETURN_POINTER | GB_RETURN_COPY |
@@ -1640,7 +1649,10 @@ psd_write_image_data(psd_write_ctx *xc, gx_device_printer *pdev)
     params.x_offset = 0;
     params.raster = bitmap_raster(pdev->width * pdev->color_info.depth);
 
-    sep_line = gs_alloc_bytes(pdev->memory, octets_per_line, "psd_write_sep_line");
+    strip_rows = PSD_STRIP_BYTES / (max(octets_per_line, 1) * max(num_comp, 1));
+    strip_rows = max(1, min(strip_rows, min(PSD_MAX_STRIP_ROWS, xc->height)));
+    plane_strip_size = (size_t)strip_rows * octets_per_line;
+    sep_line = gs_alloc_bytes(pdev->memory, plane_strip_size * num_comp, "psd_write_sep_line");
 
     for (chan_idx = 0; chan_idx < num_comp; chan_idx++) {
         planes[chan_idx] = gs_alloc_bytes(pdev->memory, raster_plane,
@@ -1660,46 +1672,58 @@ psd_write_image_data(psd_write_ctx *xc, gx_device_printer *pdev)
     if (code < 0)
         goto cleanup;
 
+    image_start = gp_ftell(xc->f);
+    if (image_start < 0) {
+        code = gs_note_error(gs_error_ioerror);
+        goto cleanup;
+    }
+
     /* Print the output planes */
-    for (j = 0; j < xc->height; ++j) {
-        code = gx_downscaler_get_bits_rectangle(&ds, &params, j);
-        if (code < 0)
-            goto cleanup;
-        for (chan_idx = 0; chan_idx < num_comp; chan_idx++) {
-            int data_pos = xc->chnl_to_position[chan_idx];
-            if (data_pos >= 0) {
+    for (j = 0; j < xc->height; j += rows) {
+        rows = min(strip_rows, xc->height - j);
+        for (r = 0; r < rows; r++) {
+            code = gx_downscaler_get_bits_rectangle(&ds, &params, j + r);
+            if (code < 0)
+                goto cleanup;
+            for (chan_idx = 0; chan_idx < num_comp; chan_idx++) {
+                int data_pos = xc->chnl_to_position[chan_idx];
+                byte *line = sep_line + plane_strip_size * chan_idx +
+                             (size_t)r * octets_per_line;
 
-                unpacked = params.data[data_pos];
+                if (data_pos >= 0) {
 
-                if (base_num_channels == 3) {
-                    memcpy(sep_line, unpacked, octets_per_line);
-                } else if (octets_per_component == 1) {
-                    for (i = 0; i < xc->width; ++i) {
-                        sep_line[i] = 255 - unpacked[i];
-                    }
-                } else { /* octets_per_component == 2 */
-                    for (i = 0; i < xc->width; ++i) {
-                        ((unsigned short *)sep_line)[i] = 65535 - ((unsigned short *)unpacked)[i];
+                    unpacked = params.data[data_pos];
+
+                    if (base_num_channels == 3) {
+                        memcpy(line, unpacked, octets_per_line);
+                    } else if (octets_per_component == 1) {
+                        for (i = 0; i < xc->width; ++i) {
+                            line[i] = 255 - unpacked[i];
+                        }
+                    } else { /* octets_per_component == 2 */
+                        for (i = 0; i < xc->width; ++i) {
+                            ((unsigned short *)line)[i] = 65535 - ((unsigned short *)unpacked)[i];
+                        }
                     }
+                } else if (chan_idx < NUM_CMYK_COMPONENTS) {
+                    /* Write empty process color in the area */
+                    memset(line,255,octets_per_line);
                 }
-                psd_write(xc, sep_line, octets_per_line);
-            } else if (chan_idx < NUM_CMYK_COMPONENTS) {
-                /* Write empty process color in the area */
-                memset(sep_line,255,octets_per_line);
-                psd_write(xc, sep_line, octets_per_line);
-            }
-            code = gp_fseek(xc->f, ((gs_offset_t)xc->height-1) * octets_per_line, SEEK_CUR);
-            if (code < 0) {
-                code = gs_note_error(gs_error_ioerror);
-                goto cleanup;
             }
         }
-        if (j < xc->height-1) {
-            code = gp_fseek(xc->f, -((gs_offset_t)num_comp * xc->height - 1) * octets_per_line, SEEK_CUR);
+        for (chan_idx = 0; chan_idx < num_comp; chan_idx++) {
+            if (xc->chnl_to_position[chan_idx] < 0 &&
+                chan_idx >= NUM_CMYK_COMPONENTS)
+                continue;
+            code = gp_fseek(xc->f, image_start +
+                            ((gs_offset_t)chan_idx * xc->height + j) * octets_per_line,
+                            SEEK_SET);
             if (code < 0) {
                 code = gs_note_error(gs_error_ioerror);
                 goto cleanup;
             }
+            psd_write(xc, sep_line + plane_strip_size * chan_idx,
+                      rows * octets_per_line);
         }
     }
 
@@ -47,6 +47,7 @@
 #include "gdevppla.h"
 #include "gxdownscale.h"
 #include "gp.h"
+#include "gpsync.h"
 #include "gstiffio.h"
 #include "gscms.h"
 #include "gsicc_cache.h"
@@ -2046,6 +2047,132 @@ print_cmyk_equivalent_colors(tiffsep_device *tfdev, int num_comp, cmyk_composite
     return 0;
 }
 
+/*
+ * The separation files and the composite file of a tiffsep page don't
+ * depend on one another, so when NumRenderingThreads asks for threads we
+ * write them in parallel. The page is pulled from the downscaler a strip
+ * of rows at a time, and then each file's share of the strip (converting,
+ * compressing and writing) is done by one of several threads. Each file
+ * is still written by one thread at a time, in row order, so the output
+ * is the same as when it is all done on one thread.
+ */
+#define TIFFSEP_STRIP_BYTES (4 << 20)   /* aim for strips about this big */
+#define TIFFSEP_MAX_STRIP_ROWS 64
+#define TIFFSEP_MAX_THREADS 16
+
+typedef struct tiffsep_strip_s {
+    tiffsep_device *tfdev;
+    int num_comp;
+    int num_order;
+    int width;
+    int byte_width;
+    int dst_bpc;
+    cmyk_composite_map *cmyk_map;
+    int num_jobs;               /* separation files, then the composite */
+    int y;                      /* first row of the strip */
+    int rows;
+    byte *data[GS_CLIENT_COLOR_MAX_COMPONENTS]; /* rows of each plane used */
+} tiffsep_strip_t;
+
+typedef struct tiffsep_worker_s {
+    tiffsep_strip_t *strip;
+    int first_job;
+    int job_step;
+    byte *line;                 /* the line being written */
+} tiffsep_worker_t;
+
+static void
+tiffsep_write_strip_job(tiffsep_strip_t *strip, int job, byte *line)
+{
+    tiffsep_device *tfdev = strip->tfdev;
+    int byte_width = strip->byte_width;
+    int r, pixel;
+
+    if (job < strip->num_jobs - 1) {
+        /* Write separation data (tiffgray format) */
+        int plane = (strip->num_order > 0 ?
+                     tfdev->devn_params.separation_order_map[job] : job);
+
+        for (r = 0; r < strip->rows; r++) {
+            const byte *src = strip->data[plane] + (size_t)r * byte_width;
+
+            for (pixel = 0; pixel < byte_width; pixel++)
+                line[pixel] = MAX_COLOR_VALUE - src[pixel];    /* Gray is additive */
+            TIFFWriteScanline(tfdev->tiff[job], (tdata_t)line, strip->y + r, 0);
+        }
+        return;
+    }
+    /* Write CMYK equivalent data */
+    for (r = 0; r < strip->rows; r++) {
+        gs_get_bits_params_t params;
+        int comp_num;
+
+        for (comp_num = 0; comp_num < strip->num_comp; comp_num++) {
+            int plane = tfdev->devn_params.separation_order_map[comp_num];
+
+            params.data[plane] = strip->data[plane] + (size_t)r * byte_width;
+        }
+        switch(strip->dst_bpc)
+        {
+        default:
+        case 8:
+            build_cmyk_raster_line_fromplanar(&params, line, strip->width,
+                                              strip->num_comp, strip->cmyk_map,
+                                              strip->num_order, tfdev);
+            break;
+        case 4:
+            build_cmyk_raster_line_fromplanar_4bpc(&params, line, strip->width,
+                                                   strip->num_comp, strip->cmyk_map,
+                                                   strip->num_order, tfdev);
+            break;
+        case 2:
+            build_cmyk_raster_line_fromplanar_2bpc(&params, line, strip->width,
+                                                   strip->num_comp, strip->cmyk_map,
+                                                   strip->num_order, tfdev);
+            break;
+        case 1:
+            build_cmyk_raster_line_fromplanar_1bpc(&params, line, strip->width,
+                                                   strip->num_comp, strip->cmyk_map,
+                                                   strip->num_order, tfdev);
+            break;
+        }
+        TIFFWriteScanline(tfdev->tiff_comp, (tdata_t)line, strip->y + r, 0);
+    }
+}
+
+static void
+tiffsep_write_strip_worker(void *arg)
+{
+    tiffsep_worker_t *worker = (tiffsep_worker_t *)arg;
+    int job;
+
+    for (job = worker->first_job; job < worker->strip->num_jobs;
+         job += worker->job_step)
+        tiffsep_write_strip_job(worker->strip, job, worker->line);
+}
+
+/* Write a strip, sharing the files out between the workers. The first
+ * worker's share is done on this thread, as is that of any worker we
+ * can't start a thread for. */
+static void
+tiffsep_write_strip(tiffsep_worker_t *workers, int num_workers)
+{
+    gp_thread_id threads[TIFFSEP_MAX_THREADS];
+    int i;
+
+    for (i = 1; i < num_workers; i++) {
+        if (gp_thread_start(tiffsep_write_strip_worker, &workers[i], &threads[i]) < 0) {
+            threads[i] = NULL;
+            tiffsep_write_strip_worker(&workers[i]);
+        }
+    }
+    tiffsep_write_strip_worker(&workers[0]);
+    for (i = 1; i < num_workers; i++) {
+        if (threads[i] != NULL)
+            gp_thread_finish(threads[i]);
+    }
+}
+
 /*
  * Output the image data for the tiff separation (tiffsep) device.  The data
  * for the tiffsep device is written in separate planes to separate files.
@@ -2216,17 +2343,40 @@ tiffsep_print_page(gx_device_printer * pdev, gp_file * file)
         int raster_plane = bitmap_raster(width * 8);
         byte *planes[GS_CLIENT_COLOR_MAX_COMPONENTS] = { 0 };
         int cmyk_raster = width * NUM_CMYK_COMPONENTS;
-        int pixel, y;
+        int y, r;
         byte * sep_line;
         int plane_index;
         int offset_plane = 0;
-
+        tiffsep_strip_t strip;
+        tiffsep_worker_t workers[TIFFSEP_MAX_THREADS];
+        int num_workers, strip_rows, num_used;
+        bool used[GS_CLIENT_COLOR_MAX_COMPONENTS];
+
+        memset(&strip, 0, sizeof(strip));
+        strip.tfdev = tfdev;
+        strip.num_comp = num_comp;
+        strip.num_order = num_order;
+        strip.width = width;
+        strip.dst_bpc = dst_bpc;
+        strip.cmyk_map = cmyk_map;
+        strip.num_jobs = (tfdev->NoSeparationFiles ? 0 : num_comp) + 1;
+        num_workers = min(pdev->num_render_threads_requested,
+                          min(strip.num_jobs, TIFFSEP_MAX_THREADS));
+        if (num_workers < 1)
+            num_workers = 1;
         sep_line =
-            gs_alloc_bytes(pdev->memory, cmyk_raster, "tiffsep_print_page");
+            gs_alloc_bytes(pdev->memory, (size_t)cmyk_raster * num_workers,
+                           "tiffsep_print_page");
         if (!sep_line) {
             code = gs_note_error(gs_error_VMerror);
             goto done;
         }
+        for (r = 0; r < num_workers; r++) {
+            workers[r].strip = &strip;
+            workers[r].first_job = r;
+            workers[r].job_step = num_workers;
+            workers[r].line = sep_line + (size_t)cmyk_raster * r;
+        }
 
         if (!tfdev->NoSeparationFiles)
             for (comp_num = 0; comp_num < num_comp; comp_num++ )
@@ -2315,54 +2465,57 @@ tiffsep_print_page(gx_device_printer * pdev, gp_file * file)
             if (code < 0)
                 goto cleanup;
             byte_width = (width * dst_bpc + 7)>>3;
-            for (y = 0; y < height; ++y) {
-                code = gx_downscaler_get_bits_rectangle(&ds, &params, y);
-                if (code < 0)
+            strip.byte_width = byte_width;
+            /* Keep a strip of rows of each plane that is written: the
+               ones the composite is made from, and the ones the separation
+               files are written from. */
+            memset(used, 0, sizeof(used));
+            num_used = 0;
+            for (comp_num = 0; comp_num < num_comp; comp_num++) {
+                int composite_plane = tfdev->devn_params.separation_order_map[comp_num];
+                int sep_plane = (num_order > 0 || tfdev->NoSeparationFiles ?
+                                 composite_plane : comp_num);
+
+                if (!used[composite_plane]) {
+                    used[composite_plane] = true;
+                    num_used++;
+                }
+                if (!used[sep_plane]) {
+                    used[sep_plane] = true;
+                    num_used++;
+                }
+            }
+            strip_rows = TIFFSEP_STRIP_BYTES / (byte_width * max(num_used, 1));
+            strip_rows = max(1, min(strip_rows, TIFFSEP_MAX_STRIP_ROWS));
+            for (plane_index = 0; plane_index < GS_CLIENT_COLOR_MAX_COMPONENTS; plane_index++) {
+                if (!used[plane_index])
+                    continue;
+                strip.data[plane_index] =
+                    gs_alloc_bytes(pdev->memory, (size_t)strip_rows * byte_width,
+                                   "tiffsep_print_page");
+                if (strip.data[plane_index] == NULL) {
+                    code = gs_note_error(gs_error_VMerror);
                     goto cleanup;
-                /* Write separation data (tiffgray format) */
-                if (!tfdev->NoSeparationFiles) {
-                    for (comp_num = 0; comp_num < num_comp; comp_num++) {
-                        byte *src;
-                        byte *dest = sep_line;
-
-                        if (num_order > 0) {
-                            src = params.data[tfdev->devn_params.separation_order_map[comp_num]];
-                        }
-                        else
-                            src = params.data[comp_num];
-                        for (pixel = 0; pixel < byte_width; pixel++, dest++, src++)
-                            *dest = MAX_COLOR_VALUE - *src;    /* Gray is additive */
-                        TIFFWriteScanline(tfdev->tiff[comp_num], (tdata_t)sep_line, y, 0);
-                    }
                 }
-                /* Write CMYK equivalent data */
-                switch(dst_bpc)
-                {
-                default:
-                case 8:
-                    build_cmyk_raster_line_fromplanar(&params, sep_line, width,
-                                                      num_comp, cmyk_map, num_order,
-                                                      tfdev);
-                    break;
-                case 4:
-                    build_cmyk_raster_line_fromplanar_4bpc(&params, sep_line, width,
-                                                           num_comp, cmyk_map, num_order,
-                                                           tfdev);
-                    break;
-                case 2:
-                    build_cmyk_raster_line_fromplanar_2bpc(&params, sep_line, width,
-                                                           num_comp, cmyk_map, num_order,
-                                                           tfdev);
-                    break;
-                case 1:
-                    build_cmyk_raster_line_fromplanar_1bpc(&params, sep_line, width,
-                                                           num_comp, cmyk_map, num_order,
-                                                           tfdev);
-                    break;
+            }
+            for (y = 0; y < height; y += strip.rows) {
+                strip.y = y;
+                strip.rows = min(strip_rows, height - y);
+                for (r = 0; r < strip.rows; r++) {
+                    code = gx_downscaler_get_bits_rectangle(&ds, &params, y + r);
+                    if (code < 0)
+                        goto cleanup;
+                    for (plane_index = 0; plane_index < GS_CLIENT_COLOR_MAX_COMPONENTS; plane_index++)
+                        if (strip.data[plane_index] != NULL)
+                            memcpy(strip.data[plane_index] + (size_t)r * byte_width,
+                                   params.data[plane_index], byte_width);
                 }
-                TIFFWriteScanline(tfdev->tiff_comp, (tdata_t)sep_line, y, 0);
+                tiffsep_write_strip(workers, num_workers);
             }
 cleanup:
+            for (plane_index = 0; plane_index < GS_CLIENT_COLOR_MAX_COMPONENTS; plane_index++)
+                gs_free_object(pdev->memory, strip.data[plane_index],
+                               "tiffsep_print_page");
             if (num_order > 0) {
                 /* Free up the standard colorants if num_order was set.
                    In this process, we need to make sure that none of them
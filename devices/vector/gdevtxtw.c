@@ -15,6 +15,7 @@
 
 /*$Id: gdevtxtw.c 7795 2007-03-23 13:56:11Z tim $ */
 /* Device for Unicode (UTF-8 or UCS2) text extraction */
+#include <stdlib.h>		/* for qsort */
 #include "memory_.h"
 #include "string_.h"
 #include "gp.h"			/* for gp_file_name_sizeof */
@@ -88,6 +89,15 @@ typedef struct page_text_s {
     int PageNum;
     page_text_list_t *y_ordered_list;
     text_list_entry_t *unsorted_text_list;
+    text_list_entry_t *unsorted_text_tail;
+    /* Fragments waiting to be sorted into y_ordered_list, in the order
+     * they were added. Sorting them one at a time as they arrive is
+     * quadratic in the number of fragments on the page, so we do it all
+     * at once when the page is output.
+     */
+    text_list_entry_t *new_fragments;
+    text_list_entry_t *new_fragments_tail;
+    int new_fragment_count;
 } page_text_t;
 
 /* The custom sub-classed device structure */
@@ -202,6 +212,9 @@ txtwrite_open_device(gx_device * dev)
 
     tdev->PageData.PageNum = 0;
     tdev->PageData.y_ordered_list = NULL;
+    tdev->PageData.unsorted_text_list = tdev->PageData.unsorted_text_tail = NULL;
+    tdev->PageData.new_fragments = tdev->PageData.new_fragments_tail = NULL;
+    tdev->PageData.new_fragment_count = 0;
     tdev->file = NULL;
 #ifdef TRACE_TXTWRITE
     tdev->DebugFile = gp_fopen(dev->memory,"/temp/txtw_dbg.txt", "wb+");
@@ -232,6 +245,152 @@ txtwrite_close_device(gx_device * dev)
     return code;
 }
 
+typedef struct sort_entry_s {
+    text_list_entry_t *entry;
+    int order;			/* order in which the fragment was added */
+} sort_entry_t;
+
+static int compare_fragments(const void *a, const void *b)
+{
+    const sort_entry_t *A = (const sort_entry_t *)a, *B = (const sort_entry_t *)b;
+
+    if (A->entry->start.y != B->entry->start.y)
+        return (A->entry->start.y < B->entry->start.y ? -1 : 1);
+    if (A->entry->start.x != B->entry->start.x)
+        return (A->entry->start.x < B->entry->start.x ? -1 : 1);
+    return A->order - B->order;
+}
+
+/* Routine to sort the fragments added since the last page was output into
+ * lists of fragments with the same y co-ordinate, in x order, which are in
+ * turn kept in a y-ordered list. Fragments at the same position stay in the
+ * order they were added. Each line starts at the first of its fragments to
+ * be added, and spans the FontBBoxes of its fragments; except that the line
+ * holding the first fragment on the page starts with an empty extent at 0.
+ */
+static int sort_fragments(gx_device_txtwrite_t *tdev)
+{
+    page_text_t *page = &tdev->PageData;
+    int count = page->new_fragment_count, i, line_order = 0;
+    page_text_list_t *y_list = NULL;
+    text_list_entry_t *entry;
+    sort_entry_t *sorted;
+    bool have_extent = false;
+
+    if (count == 0)
+        return 0;
+
+    sorted = (sort_entry_t *)gs_malloc(tdev->memory->stable_memory, count,
+        sizeof(sort_entry_t), "txtwrite alloc sort array");
+    if (!sorted)
+        return gs_note_error(gs_error_VMerror);
+    for (i = 0, entry = page->new_fragments; i < count; i++, entry = entry->next) {
+        sorted[i].entry = entry;
+        sorted[i].order = i;
+    }
+    qsort(sorted, count, sizeof(sort_entry_t), compare_fragments);
+
+    for (i = 0; i < count; i++) {
+        entry = sorted[i].entry;
+        if (!y_list || entry->start.y != y_list->start.y) {
+            page_text_list_t *Y_Entry = (page_text_list_t *)gs_malloc(tdev->memory->stable_memory, 1,
+                sizeof(page_text_list_t), "txtwrite alloc Y-list");
+
+            if (!Y_Entry) {
+                int j;
+
+                /* Leave the rest of the fragments waiting to be sorted */
+                for (j = i; j < count; j++) {
+                    sorted[j].entry->previous = (j > i ? sorted[j - 1].entry : NULL);
+                    sorted[j].entry->next = (j + 1 < count ? sorted[j + 1].entry : NULL);
+                }
+                page->new_fragments = sorted[i].entry;
+                page->new_fragments_tail = sorted[count - 1].entry;
+                page->new_fragment_count = count - i;
+                gs_free(tdev->memory, sorted, count, sizeof(sort_entry_t), "txtwrite free sort array");
+                return gs_note_error(gs_error_VMerror);
+            }
+            memset(Y_Entry, 0x00, sizeof(page_text_list_t));
+            Y_Entry->x_ordered_list = entry;
+            Y_Entry->start = entry->start;
+            entry->previous = NULL;
+            if (y_list)
+                y_list->next = Y_Entry;
+            else
+                page->y_ordered_list = Y_Entry;
+            Y_Entry->previous = y_list;
+            y_list = Y_Entry;
+            line_order = sorted[i].order;
+            have_extent = false;
+        } else {
+            entry->previous = sorted[i - 1].entry;
+            entry->previous->next = entry;
+            if (sorted[i].order < line_order) {
+                y_list->start = entry->start;
+                line_order = sorted[i].order;
+            }
+        }
+        entry->next = NULL;
+
+        if (sorted[i].order == 0) {
+            if (!have_extent)
+                y_list->MinY = y_list->MaxY = 0;
+            else {
+                if (y_list->MinY > 0)
+                    y_list->MinY = 0;
+                if (y_list->MaxY < 0)
+                    y_list->MaxY = 0;
+            }
+        } else {
+            float y0 = entry->FontBBox_bottomleft.y, y1 = entry->FontBBox_topright.y;
+
+            if (y0 > y1) {
+                y0 = entry->FontBBox_topright.y;
+                y1 = entry->FontBBox_bottomleft.y;
+            }
+            if (!have_extent || y0 < y_list->MinY)
+                y_list->MinY = y0;
+            if (!have_extent || y1 > y_list->MaxY)
+                y_list->MaxY = y1;
+        }
+        have_extent = true;
+    }
+    gs_free(tdev->memory, sorted, count, sizeof(sort_entry_t), "txtwrite free sort array");
+    page->new_fragments = page->new_fragments_tail = NULL;
+    page->new_fragment_count = 0;
+    return 0;
+}
+
+/* Test whether any fragment of one line collides horizontally with any
+ * fragment of another, that is whether a fragment of the upper line starts
+ * within a fragment of the lower line, or a fragment of the lower line
+ * starts within a fragment of the upper line. Both lines are in x order,
+ * so we can sweep along them together rather than test every pair.
+ */
+static bool lines_collide(text_list_entry_t *upper, text_list_entry_t *lower)
+{
+    /* The furthest end of the lower fragments which start at or before
+     * the current upper fragment. */
+    float lower_end = 0;
+    bool have_lower_end = false;
+
+    for (; upper; upper = upper->next) {
+        while (lower && lower->start.x <= upper->start.x) {
+            if (!have_lower_end || lower->end.x > lower_end)
+                lower_end = lower->end.x;
+            have_lower_end = true;
+            lower = lower->next;
+        }
+        if (have_lower_end && upper->start.x <= lower_end)
+            return true;
+        /* Only the next lower fragment can be the first to start inside
+         * this upper one. */
+        if (lower && upper->end.x > lower->start.x)
+            return true;
+    }
+    return false;
+}
+
 /* Routine inspects horizontal lines of text to see if they can be collapsed
  * into a single line. This essentially detects superscripts and subscripts
  * as well as lines which are slightly mis-aligned.
@@ -250,27 +409,7 @@ static int merge_vertically(gx_device_txtwrite_t *tdev)
 
         if (overlap >= (y_list->MaxY - y_list->MinY) / 4) {
             /* At least a 25% overlap, lets test for x collisions */
-            text_list_entry_t *upper = y_list->x_ordered_list, *lower;
-            while (upper && !collision) {
-                lower = next->x_ordered_list;
-                while (lower && !collision) {
-                    if (upper->start.x >= lower->start.x) {
-                        if (upper->start.x <= lower->end.x) {
-                            /* Collision */
-                            collision = true;
-                            break;
-                        }
-                    } else {
-                        if (upper->end.x > lower->start.x) {
-                            /* Collision */
-                            collision = true;
-                            break;
-                        }
-                    }
-                    lower = lower->next;
-                }
-                upper = upper->next;
-            }
+            collision = lines_collide(y_list->x_ordered_list, next->x_ordered_list);
             if (!collision) {
                 text_list_entry_t *from, *to, *new_order, *current;
                 /* Consolidate y lists */
@@ -912,6 +1051,10 @@ txtwrite_output_page(gx_device * dev, int num_copies, int flush)
             return code;
     }
 
+    code = sort_fragments(tdev);
+    if (code < 0)
+        return code;
+
     switch(tdev->TextFormat) {
         case 0:
         case 1:
@@ -986,7 +1129,7 @@ txtwrite_output_page(gx_device * dev, int num_copies, int flush)
         gs_free(tdev->memory, x_entry, 1, sizeof(text_list_entry_t), "txtwrite free unsorted text fragment");
         x_entry = next_x;
     }
-    tdev->PageData.unsorted_text_list = NULL;
+    tdev->PageData.unsorted_text_list = tdev->PageData.unsorted_text_tail = NULL;
 
     code = gx_parse_output_file_name(&parsed, &fmt, tdev->fname,
                                          strlen(tdev->fname), tdev->memory);
@@ -1594,7 +1737,8 @@ txtwrite_process_plain_text(gs_text_enum_t *pte)
 
 /* Routine to add the accumulated text, and its recorded properties to our
  * lists. We maintain a list of text on a per-page basis. Each fragment is
- * sorted by Y co-ordinate, then by X co-ordinate, and stored that way.
+ * sorted by Y co-ordinate, then by X co-ordinate, and stored that way (see
+ * sort_fragments() below, which does the sorting when the page is output).
  * Eventually we will want to merge 'adjacent' fragments with the same
  * properties, at least when outputting a simple representation. We won't
  * do this for languages which don't read left/right or right/left though.
@@ -1602,92 +1746,16 @@ txtwrite_process_plain_text(gs_text_enum_t *pte)
 static int
 txt_add_sorted_fragment(gx_device_txtwrite_t *tdev, textw_text_enum_t *penum)
 {
-    if (!tdev->PageData.y_ordered_list) {
-        /* first entry, no need to sort, just store it */
-        tdev->PageData.y_ordered_list = (page_text_list_t *)gs_malloc(tdev->memory->stable_memory, 1,
-            sizeof(page_text_list_t), "txtwrite alloc Y list entry");
-        if (!tdev->PageData.y_ordered_list)
-            return gs_note_error(gs_error_VMerror);
-        memset(tdev->PageData.y_ordered_list, 0x00, sizeof(page_text_list_t));
-        tdev->PageData.y_ordered_list->x_ordered_list = penum->text_state;
-        tdev->PageData.y_ordered_list->next = tdev->PageData.y_ordered_list->previous = NULL;
-        tdev->PageData.y_ordered_list->start = penum->text_state->start;
-    } else {
-        page_text_list_t *Y_List = tdev->PageData.y_ordered_list;
-
-        while (Y_List->next && Y_List->start.y < penum->text_state->start.y)
-            Y_List = Y_List->next;
-
-        if (Y_List->start.y == penum->text_state->start.y) {
-            /* Already have text at this y-position */
-            text_list_entry_t *X_List = Y_List->x_ordered_list;
-
-            while (X_List->next && X_List->start.x <= penum->text_state->start.x)
-                X_List = X_List->next;
-
-            if (X_List->start.x > penum->text_state->start.x) {
-                /* Insert before */
-                penum->text_state->next = X_List;
-                penum->text_state->previous = X_List->previous;
-                X_List->previous = penum->text_state;
-                if (!penum->text_state->previous)
-                    /* New head of list */
-                    Y_List->x_ordered_list = penum->text_state;
-                else
-                    penum->text_state->previous->next = penum->text_state;
-            } else {
-                /* Insert after */
-                penum->text_state->previous = X_List;
-                penum->text_state->next = X_List->next;
-                X_List->next = penum->text_state;
-                if (penum->text_state->next)
-                    penum->text_state->next->previous = penum->text_state;
-            }
-            if (penum->text_state->FontBBox_bottomleft.y < Y_List->MinY)
-                Y_List->MinY = penum->text_state->FontBBox_bottomleft.y;
-            if (penum->text_state->FontBBox_bottomleft.y > Y_List->MaxY)
-                Y_List->MaxY = penum->text_state->FontBBox_bottomleft.y;
-            if (penum->text_state->FontBBox_topright.y < Y_List->MinY)
-                Y_List->MinY = penum->text_state->FontBBox_topright.y;
-            if (penum->text_state->FontBBox_topright.y > Y_List->MaxY)
-                Y_List->MaxY = penum->text_state->FontBBox_topright.y;
-        } else {
-            /* New y-position, make a Y list new record */
-            page_text_list_t *Y_Entry = (page_text_list_t *)gs_malloc(tdev->memory->stable_memory, 1,
-                sizeof(page_text_list_t), "txtwrite alloc Y-list");
-            if (!Y_Entry)
-                return gs_note_error(gs_error_VMerror);
-
-            Y_Entry->x_ordered_list = penum->text_state;
-            Y_Entry->start = penum->text_state->start;
-            if (penum->text_state->FontBBox_bottomleft.y > penum->text_state->FontBBox_topright.y) {
-                Y_Entry->MinY = penum->text_state->FontBBox_topright.y;
-                Y_Entry->MaxY = penum->text_state->FontBBox_bottomleft.y;
-            } else {
-                Y_Entry->MaxY = penum->text_state->FontBBox_topright.y;
-                Y_Entry->MinY = penum->text_state->FontBBox_bottomleft.y;
-            }
-
-            if (Y_List->start.y > penum->text_state->start.y) {
-                /* Insert before */
-                Y_Entry->next = Y_List;
-                Y_Entry->previous = Y_List->previous;
-                Y_List->previous = Y_Entry;
-                if (!Y_Entry->previous)
-                    /* New head of list */
-                    tdev->PageData.y_ordered_list = Y_Entry;
-                else
-                    ((page_text_list_t *)Y_Entry->previous)->next = Y_Entry;
-            } else {
-                /* Insert after */
-                Y_Entry->next = Y_List->next;
-                Y_Entry->previous = Y_List;
-                Y_List->next = Y_Entry;
-                if (Y_Entry->next)
-                    ((page_text_list_t *)(Y_Entry->next))->previous = Y_Entry;
-            }
-        }
-    }
+    page_text_t *page = &tdev->PageData;
+
+    penum->text_state->next = NULL;
+    penum->text_state->previous = page->new_fragments_tail;
+    if (page->new_fragments_tail)
+        page->new_fragments_tail->next = penum->text_state;
+    else
+        page->new_fragments = penum->text_state;
+    page->new_fragments_tail = penum->text_state;
+    page->new_fragment_count++;
     penum->text_state = NULL;
     return 0;
 }
@@ -1809,13 +1877,12 @@ txt_add_fragment(gx_device_txtwrite_t *tdev, textw_text_enum_t *penum)
         tdev->PageData.unsorted_text_list = unsorted_entry;
         unsorted_entry->next = unsorted_entry->previous = NULL;
     } else {
-        t = tdev->PageData.unsorted_text_list;
-        while (t->next)
-            t = t->next;
+        t = tdev->PageData.unsorted_text_tail;
         t->next = unsorted_entry;
         unsorted_entry->next = NULL;
         unsorted_entry->previous = t;
     }
+    tdev->PageData.unsorted_text_tail = unsorted_entry;
 
     /* Then add the other entry to the sorted list */
     return txt_add_sorted_fragment(tdev, penum);
@@ -543,6 +543,7 @@ img_impl_process(pl_interp_implementation_t * impl, stream_cursor_read * pr)
                 break;
             }
             ok = jpeg_read_header(&img->cinfo, TRUE);
+            img->cinfo.do_fancy_upsampling = FALSE;
             need_more_data = consume_jpeg_data(img, pr);
             if (ok == JPEG_SUSPENDED)
                 break;
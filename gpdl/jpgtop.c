@@ -557,6 +557,7 @@ jpg_impl_process(pl_interp_implementation_t * impl, stream_cursor_read * pr)
                 break;
             }
             ok = jpeg_read_header(&jpg->cinfo, TRUE);
+            jpg->cinfo.do_fancy_upsampling = FALSE;
             need_more_data = consume_jpeg_data(jpg, pr);
             if (ok == JPEG_SUSPENDED)
                 break;
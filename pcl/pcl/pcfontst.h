@@ -35,4 +35,21 @@ typedef struct pcl_font_selection_s
     pl_symbol_map_t *map;
 } pcl_font_selection_t;
 
+/*
+ * Memo of recent font selections by parameters. An entry is only valid
+ * while the font and symbol set dictionaries are unchanged, which is
+ * tracked by their generation numbers.
+ */
+#define PCL_FONT_SELECTION_MEMO_SIZE 16
+
+typedef struct pcl_font_selection_memo_s
+{
+    pl_font_params_t params;
+    bool internal_only;
+    int lp_orient;
+    uint generation[4];
+    pl_font_t *font;            /* 0 means the entry is empty */
+    pl_symbol_map_t *map;
+} pcl_font_selection_memo_t;
+
 #endif /* pcfontst_INCLUDED */
@@ -443,6 +443,60 @@ score_match(const pcl_state_t * pcs, const pcl_font_selection_t * pfs,
 }
 
 
+/*
+ * Selecting a font by its parameters scores every resident font, and jobs
+ * commonly flip between the same few selections over and over, so the
+ * outcome of recent selections is remembered.  The result of a selection
+ * depends only on the parameters, the fonts and symbol sets defined, and
+ * the orientation (for bitmap fonts), so a memo entry can be reused for as
+ * long as none of those have changed.
+ */
+static void
+font_selection_generation(const pcl_state_t * pcs, uint generation[4])
+{
+    generation[0] = pcs->soft_fonts.generation;
+    generation[1] = pcs->built_in_fonts.generation;
+    generation[2] = pcs->soft_symbol_sets.generation;
+    generation[3] = pcs->built_in_symbol_sets.generation;
+}
+
+static pcl_font_selection_memo_t *
+font_selection_memo_entry(const pcl_state_t * pcs,
+                          const pl_font_params_t * pfp)
+{
+    uint hash = pfp->symbol_set * 31 + pfp->typeface_family;
+
+    hash = hash * 31 + pfp->style;
+    hash = hash * 31 + (uint) pfp->stroke_weight;
+    hash = hash * 31 + pfp->height_4ths;
+    hash = hash * 31 + (uint) pfp->pitch.per_inch_x100;
+    hash = hash * 31 + pfp->proportional_spacing;
+    hash ^= hash >> 16;
+    return (pcl_font_selection_memo_t *)
+        &pcs->font_selection_memo[hash % PCL_FONT_SELECTION_MEMO_SIZE];
+}
+
+static bool
+font_selection_memo_matches(const pcl_font_selection_memo_t * pmemo,
+                            const pl_font_params_t * pfp,
+                            bool internal_only, int lp_orient,
+                            const uint generation[4])
+{
+    return pmemo->font != 0 &&
+        pmemo->internal_only == internal_only &&
+        pmemo->lp_orient == lp_orient &&
+        !memcmp(pmemo->generation, generation, sizeof(pmemo->generation)) &&
+        pmemo->params.symbol_set == pfp->symbol_set &&
+        pmemo->params.proportional_spacing == pfp->proportional_spacing &&
+        pmemo->params.pitch.cp == pfp->pitch.cp &&
+        pmemo->params.pitch.per_inch_x100 == pfp->pitch.per_inch_x100 &&
+        pmemo->params.height_4ths == pfp->height_4ths &&
+        pmemo->params.style == pfp->style &&
+        pmemo->params.stroke_weight == pfp->stroke_weight &&
+        pmemo->params.typeface_family == pfp->typeface_family &&
+        pmemo->params.pjl_font_number == pfp->pjl_font_number;
+}
+
 /* Recompute the current font from the descriptive parameters. */
 /* This is used by both PCL and HP-GL/2. */
 int
@@ -458,6 +512,8 @@ pcl_reselect_font(pcl_font_selection_t * pfs, const pcl_state_t * pcs,
         pl_symbol_map_t *mapp = 0;
         match_score_t best_match;
         score_index_t i;
+        pcl_font_selection_memo_t *pmemo;
+        uint generation[4];
 
 #ifdef DEBUG
         if (gs_debug_c('=')) {
@@ -484,6 +540,17 @@ pcl_reselect_font(pcl_font_selection_t * pfs, const pcl_state_t * pcs,
                 return 0;
             }
         }
+        font_selection_generation(pcs, generation);
+        pmemo = font_selection_memo_entry(pcs, &pfs->params);
+        if (font_selection_memo_matches(pmemo, &pfs->params, internal_only,
+                                        pcs->xfm_state.lp_orient,
+                                        generation)) {
+            pfs->font = pmemo->font;
+            pfs->map = pmemo->map;
+            pfs->selected_id = (uint) - 1;
+            return 0;
+        }
+
         /* Initialize the best match to be worse than any real font. */
         for (i = (score_index_t) 0; i < score_limit; i++)
             best_match[i] = -1;
@@ -537,6 +604,13 @@ pcl_reselect_font(pcl_font_selection_t * pfs, const pcl_state_t * pcs,
         pfs->font = best_font;
         pfs->map = best_map;
         pfs->selected_id = (uint) - 1;
+
+        pmemo->params = pfs->params;
+        pmemo->internal_only = internal_only;
+        pmemo->lp_orient = pcs->xfm_state.lp_orient;
+        memcpy(pmemo->generation, generation, sizeof(pmemo->generation));
+        pmemo->font = best_font;
+        pmemo->map = best_map;
     }
     return 0;
 }
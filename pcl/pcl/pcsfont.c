@@ -198,8 +198,11 @@ pcl_font_control(pcl_args_t * pargs, pcl_state_t * pcs)
             /* Make soft font <font_id> temporary. */
             if (pl_dict_find_no_stack
                 (&pcs->soft_fonts, CURRENT_FONT_ID, CURRENT_FONT_ID_SIZE,
-                 &value))
+                 &value)) {
                 ((pl_font_t *) value)->storage = pcds_temporary;
+                /* invalidate remembered font selections */
+                pcs->soft_fonts.generation++;
+            }
 
             break;
         case 5:
@@ -210,6 +213,7 @@ pcl_font_control(pcl_args_t * pargs, pcl_state_t * pcs)
                 ((pl_font_t *) value)->storage = pcds_permanent;
                 ((pl_font_t *) value)->params.pjl_font_number =
                     pjl_proc_register_permanent_soft_font_addition(pcs->pjls);
+                pcs->soft_fonts.generation++;
             }
             break;
         case 6:
@@ -173,6 +173,7 @@ struct pcl_state_s
     } font_selected;
     pl_font_t *font;            /* 0 means recompute from params */
     pl_dict_t built_in_fonts;   /* "built-in", known at start-up */
+    pcl_font_selection_memo_t font_selection_memo[PCL_FONT_SELECTION_MEMO_SIZE];
 
     /* Internal variables */
     gs_font_dir *font_dir;      /* gs-level dictionary of fonts */
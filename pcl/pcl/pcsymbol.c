@@ -172,6 +172,9 @@ pcl_define_symbol_set(pcl_args_t * pargs, pcl_state_t * pcs)
         }
     }
     symsetp->maps[gv] = header;
+    /* The map was changed in place, so remembered font selections that
+     * may refer to the old one are no longer valid. */
+    pcs->soft_symbol_sets.generation++;
 
     return 0;
 }
@@ -373,11 +373,11 @@ pcl_enter_graphics_mode(pcl_state_t * pcs, pcl_gmode_entry_t mode)
 int
 pcl_end_graphics_mode(pcl_state_t * pcs)
 {
-    int code = 0;
+    int code = 0, raster_code;
     gs_point cur_pt;
     gs_matrix dev2pd;
     /* close the raster; exit graphics mode */
-    pcl_complete_raster(pcs);
+    raster_code = pcl_complete_raster(pcs);
     pcs->raster_state.graphics_mode = false;
 
     /* get the new current point; then restore the graphic state */
@@ -391,8 +391,9 @@ pcl_end_graphics_mode(pcl_state_t * pcs)
     code = pcl_set_cap_x(pcs, (coord) (cur_pt.x + 0.5) - adjust_pres_mode(pcs),
                   false, false);
     if (code < 0) return code;
-    return pcl_set_cap_y(pcs, (coord) (cur_pt.y + 0.5) - pcs->margins.top,
+    code = pcl_set_cap_y(pcs, (coord) (cur_pt.y + 0.5) - pcs->margins.top,
                          false, false, false, false);
+    return (code < 0 ? code : raster_code);
 }
 
 /*
@@ -51,6 +51,13 @@
  */
 #define MAX_PLANES  8
 
+/*
+ * Single source rasters without a mask are passed to the image enumerator in
+ * blocks of rows rather than one row at a time. This is the (approximate)
+ * size of the block buffer; rows larger than half of it are not blocked.
+ */
+#define ROW_BLOCK_BYTES  65536
+
 /*
  * Structure to describe a PCL raster
  */
@@ -93,6 +100,10 @@ typedef struct pcl_raster_s
     pcl_seed_row_t *pseed_rows; /* seed rows, one per plane */
     byte *cons_buff;            /* consolidation buffer */
     byte *mask_buff;            /* buffer for mask row, if needed */
+    byte *block_buff;           /* rows not yet passed to the enumerator */
+    uint block_row_bytes;       /* size of each row in block_buff */
+    uint block_max_rows;        /* # of rows block_buff can hold */
+    uint block_rows;            /* # of rows currently in block_buff */
 
 } pcl_raster_t;
 
@@ -535,6 +546,73 @@ create_image_enumerator(pcl_raster_t * prast)
     return 0;
 }
 
+/*
+ * Pass any rows held in the block buffer to the image enumerator.
+ *
+ * Returns 0 on success, < 0 in the event of an error.
+ */
+static int
+flush_row_block(pcl_raster_t * prast)
+{
+    int code = 0;
+
+    if (prast->block_rows > 0) {
+        uint dummy;
+
+        code = gs_image_next(prast->pen,
+                             prast->block_buff,
+                             prast->block_rows * prast->block_row_bytes,
+                             &dummy);
+        prast->block_rows = 0;
+    }
+    return code;
+}
+
+/*
+ * Pass one row of a single source raster to the image enumerator. If there is
+ * no mask to be generated in step with the image, the row is copied to the
+ * block buffer, and only handed on once the buffer is full or the image is
+ * closed. Otherwise, or if the block buffer cannot be allocated, the row is
+ * passed on immediately.
+ *
+ * Returns 0 on success, < 0 in the event of an error.
+ */
+static int
+add_block_row(pcl_raster_t * prast, const byte * pb, uint nbytes)
+{
+    uint dummy;
+
+    if ((prast->gen_mask_row == 0) && (nbytes > 0) &&
+        (nbytes <= ROW_BLOCK_BYTES / 2)) {
+        if (prast->block_buff == 0) {
+            uint max_rows = ROW_BLOCK_BYTES / nbytes;
+
+            prast->block_buff = gs_alloc_bytes(prast->pmem,
+                                               max_rows * nbytes,
+                                               "PCL raster block buffer");
+            if (prast->block_buff != 0) {
+                prast->block_row_bytes = nbytes;
+                prast->block_max_rows = max_rows;
+                prast->block_rows = 0;
+            }
+        }
+        if ((prast->block_buff != 0) && (nbytes == prast->block_row_bytes)) {
+            memcpy(prast->block_buff + prast->block_rows * nbytes, pb, nbytes);
+            if (++prast->block_rows < prast->block_max_rows)
+                return 0;
+            return flush_row_block(prast);
+        }
+    }
+
+    {
+        int code = flush_row_block(prast);
+
+        if (code < 0)
+            return code;
+    }
+    return gs_image_next(prast->pen, pb, nbytes, &dummy);
+}
+
 /*
  * Close the image being used to represent a raster. If the second argument is
  * true, complete the raster as well.
@@ -547,16 +625,22 @@ create_image_enumerator(pcl_raster_t * prast)
  *     this routine. The recursion can only extend to one additional level,
  *     however, as process_zero_rows will call this routine with complete set
  *     set to false.
+ *
+ * Returns 0 on success, < 0 in the event of an error. The image is closed
+ * in either case.
  */
-static void
+static int
 close_raster(gs_gstate * pgs, pcl_raster_t * prast, bool complete)
 {
+    int code = 0;
+
     /* see if we need to fill in any missing rows */
     if (complete &&
         (prast->src_height > prast->rows_rendered) && prast->src_height_set)
         (void)process_zero_rows(prast,
                                 prast->src_height - prast->rows_rendered);
     if (prast->pen != 0) {
+        code = flush_row_block(prast);
         gs_image_cleanup(prast->pen, pgs);
         gs_free_object(prast->pmem, prast->pen, "Close PCL raster");
         prast->pen = 0;
@@ -569,6 +653,7 @@ close_raster(gs_gstate * pgs, pcl_raster_t * prast, bool complete)
     gs_translate(prast->pcs->pgs, 0.0, (double) (prast->rows_rendered));
     prast->src_height -= prast->rows_rendered;
     prast->rows_rendered = 0;
+    return code;
 }
 
 /*
@@ -721,7 +806,9 @@ process_zero_rows(pcl_raster_t * prast, int nrows)
         (prast->zero_is_white || prast->zero_is_black)) {
         gs_gstate *pgs = prast->pcs->pgs;
 
-        close_raster(pgs, prast, false);
+        code = close_raster(pgs, prast, false);
+        if (code < 0)
+            return code;
         if ((prast->zero_is_black) || !prast->pcs->source_transparent) {
             gs_rect tmp_rect;
             bool invert = prast->zero_is_white;
@@ -791,7 +878,11 @@ process_zero_rows(pcl_raster_t * prast, int nrows)
         for (i = 0; i < cnt; i++) {
             uint dummy;
 
-            if ((code = gs_image_next(pen, pb, size, &dummy)) < 0)
+            if (nsrcs == 1)
+                code = add_block_row(prast, pb, size);
+            else
+                code = gs_image_next(pen, pb, size, &dummy);
+            if (code < 0)
                 return code;
         }
         prast->rows_rendered += nrows;
@@ -847,7 +938,6 @@ process_row(pcl_raster_t * prast, int comp_mode /* modified compression mode */
     if (prast->nsrcs == 1) {
         byte *pb;
         int nbytes, b_per_p;
-        uint dummy;
 
         /* consolidate the planes if necessary */
         if (nplanes > prast->nsrcs) {
@@ -874,7 +964,7 @@ process_row(pcl_raster_t * prast, int comp_mode /* modified compression mode */
             pcl_cmap_apply_remap_ary(prast->remap_ary,
                                      pb, b_per_p, prast->src_width);
 
-        code = gs_image_next(pen, pb, nbytes, &dummy);
+        code = add_block_row(prast, pb, nbytes);
 
     } else {
         uint dummy;
@@ -1075,9 +1165,7 @@ process_adaptive_compress(pcl_raster_t * prast, const byte * pin, uint insize, b
             if (prast->nplanes == 1) {
                 prast->rows_rendered += param;
                 while ((param-- > 0) && (code >= 0)) {
-                    uint dummy;
-
-                    code = gs_image_next(pen, pdata, row_size, &dummy);
+                    code = add_block_row(prast, pdata, row_size);
                     if ((prast->gen_mask_row != 0) && (code >= 0))
                         code = process_mask_row(prast);
                 }
@@ -1192,8 +1280,12 @@ pcl_start_raster(uint src_width, uint src_height, pcl_state_t * pcs)
             pcs->pattern_type != pcl_pattern_solid_frgrnd;
 
     /* there can only be one raster object present at a time */
-    if (prast != 0)
-        pcl_complete_raster(pcs);
+    if (prast != 0) {
+        int code = pcl_complete_raster(pcs);
+
+        if (code < 0)
+            return code;
+    }
 
     prast = gs_alloc_struct(pcs->memory,
                             pcl_raster_t, &st_raster_t, "start PCL raster");
@@ -1221,9 +1313,13 @@ pcl_start_raster(uint src_width, uint src_height, pcl_state_t * pcs)
     prast->mask_pindexed = 0;
     prast->gen_mask_row = 0;
 
-    /* the conslidation and mask buffers are created when first needed */
+    /* the conslidation, mask and block buffers are created when first needed */
     prast->cons_buff = 0;
     prast->mask_buff = 0;
+    prast->block_buff = 0;
+    prast->block_row_bytes = 0;
+    prast->block_max_rows = 0;
+    prast->block_rows = 0;
 
     if (penc <= pcl_penc_indexed_by_pixel) {
         int b_per_i = pcl_cs_indexed_get_bits_per_index(pindexed);
@@ -1350,19 +1446,22 @@ pcl_start_raster(uint src_width, uint src_height, pcl_state_t * pcs)
 
 /*
  * Complete a raster. This is called when exiting graphics mode.
+ *
+ * Returns 0 on success, < 0 in the event of an error. The raster is freed
+ * in either case.
  */
-void
+int
 pcl_complete_raster(pcl_state_t * pcs)
 {
     pcl_raster_t *prast = (pcl_raster_t *) pcs->raster_state.pcur_raster;
-    int i;
+    int i, code;
 
     /* if already in raster mode, ignore */
     if (prast == 0)
-        return;
+        return 0;
 
     /* close the current raster */
-    close_raster(pcs->pgs, prast, true);
+    code = close_raster(pcs->pgs, prast, true);
 
     /* free associated objects */
     if (prast->remap_ary != 0) {
@@ -1395,10 +1494,13 @@ pcl_complete_raster(pcl_state_t * pcs)
         gs_free_object(prast->pmem, prast->cons_buff, "Complete PCL raster");
     if (prast->mask_buff != 0)
         gs_free_object(prast->pmem, prast->mask_buff, "Complete PCL raster");
+    if (prast->block_buff != 0)
+        gs_free_object(prast->pmem, prast->block_buff, "Complete PCL raster");
 
     /* free the PCL raster robject itself */
     gs_free_object(prast->pmem, prast, "Complete PCL raster");
     pcs->raster_state.pcur_raster = 0;
+    return code;
 }
 
 /*
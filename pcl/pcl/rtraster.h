@@ -30,7 +30,7 @@
 int pcl_start_raster(uint src_width, uint src_height, pcl_state_t * pcs);
 
 /* complete a raster (when exiting raster graphics mode) */
-void pcl_complete_raster(pcl_state_t * pcs);
+int pcl_complete_raster(pcl_state_t * pcs);
 
 extern const pcl_init_t rtraster_init;
 
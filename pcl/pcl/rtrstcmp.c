@@ -59,8 +59,8 @@ uncompress_1(pcl_seed_row_t * pout, const byte * pin, int in_size)
 
         if (cnt > plim - pb)
             cnt = plim - pb;
-        while (cnt-- > 0)
-            *pb++ = val;
+        memset(pb, val, cnt);
+        pb += cnt;
     }
     if (!pout->is_blank)
         memset(pb, 0, plim - pb);
@@ -88,8 +88,8 @@ uncompress_2(pcl_seed_row_t * pout, const byte * pin, int in_size)
             pin += cnt;
             if (cnt > plim - pb)
                 cnt = plim - pb;
-            while (cnt-- > 0)
-                *pb++ = *ptmp++;
+            memcpy(pb, ptmp, cnt);
+            pb += cnt;
 
         } else if ((cntrl > 128) && (i-- > 0)) {
             int cnt = min(257 - cntrl, plim - pb);
@@ -136,8 +136,8 @@ uncompress_3(pcl_seed_row_t * pout, const byte * pin, int in_size)
             break;
         if (cnt > plim - pb)
             cnt = plim - pb;
-        while (cnt-- > 0)
-            *pb++ = *ptmp++;
+        memcpy(pb, ptmp, cnt);
+        pb += cnt;
     }
     pout->is_blank = (pout->is_blank && (in_size == 0));
 }
@@ -201,8 +201,8 @@ uncompress_9(pcl_seed_row_t * pout, const byte * pin, int in_size)
 
                 if (cnt > plim - pb)
                     cnt = plim - pb;
-                while (cnt-- > 0)
-                    *pb++ = rep_val;
+                memset(pb, rep_val, cnt);
+                pb += cnt;
             }
         } else {
             if (cnt > i)
@@ -210,8 +210,9 @@ uncompress_9(pcl_seed_row_t * pout, const byte * pin, int in_size)
             i -= cnt;
             if (cnt > plim - pb)
                 cnt = plim - pb;
-            while (cnt-- > 0)
-                *pb++ = *pin++;
+            memcpy(pb, pin, cnt);
+            pb += cnt;
+            pin += cnt;
         }
 
     }
@@ -278,6 +279,28 @@ mode10_merge_delta(const uint8_t ** src, uint32_t oldpixel, int *countdown)
     return pixel;
 }
 
+/*
+ * Fill with a run of 24 bit pixels: write the first pixel, then keep doubling
+ * the filled area by copying it onto the remainder.
+ */
+static inline void
+mode10_fill_pixels(byte * pb, uint32_t pixel, int npixels)
+{
+    int done = 3, total = npixels * 3;
+
+    if (npixels <= 0)
+        return;
+    pb[0] = (pixel >> 16) & 0xff;
+    pb[1] = (pixel >> 8) & 0xff;
+    pb[2] = (pixel >> 0) & 0xff;
+    while (done < total) {
+        int n = min(done, total - done);
+
+        memcpy(pb + done, pb, n);
+        done += n;
+    }
+}
+
 static void
 uncompress_10(pcl_seed_row_t * pout, const byte * pin, int in_size)
 {
@@ -354,14 +377,16 @@ uncompress_10(pcl_seed_row_t * pout, const byte * pin, int in_size)
 		} while (*pin++ == 0xff);
 	    }
 	    if_debug1('w', "rcnt %d\n", cnt);
-	    for (j = 0; j < cnt; j++) {
-		if ((pb + 3) > plim) {
+	    {
+		/* pixels which would run off the end of the row are dropped */
+		int room = (pb < plim ? (plim - pb) / 3 : 0);
+
+		if (cnt > room) {
 		    if_debug0('|', "pixel over run 1\n");
-		} else {
-		    *pb++ = (pixel >> 16) & 0xff;
-		    *pb++ = (pixel >> 8) & 0xff;
-		    *pb++ = (pixel >> 0) & 0xff;
+		    cnt = room;
 		}
+		mode10_fill_pixels(pb, pixel, cnt);
+		pb += cnt * 3;
 	    }
 	} else {
 	    if ((pb + 3) > plim)
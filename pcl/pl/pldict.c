@@ -103,6 +103,7 @@ pl_dict_free(pl_dict_t * pdict, pl_dict_entry_t ** ppde, client_name_t cname)
         gs_free_string(mem, (byte *) pde->key.data, pde->key.size, cname);
     gs_free_object(mem, pde, cname);
     pdict->entry_count--;
+    pdict->generation++;
 }
 
 /* ---------------- API procedures ---------------- */
@@ -117,6 +118,7 @@ pl_dict_init(pl_dict_t * pdict, gs_memory_t * mem,
     pdict->entries = 0;
     pdict->entry_count = 0;
     pdict->parent = 0;
+    pdict->generation = 0;
 }
 
 /*
@@ -172,6 +174,7 @@ pl_dict_build_new_entry(pl_dict_t * pdict, const byte * kdata, uint ksize,
     pde->next = pdict->entries;
     pdict->entries = pde;
     pdict->entry_count++;
+    pdict->generation++;
     return 0;
 }
 
@@ -201,6 +204,7 @@ pl_dict_put(pl_dict_t * pdict, const byte * kdata, uint ksize, void *value)
         (*pdict->free_proc) (pdict->memory, pde->value,
                              "pl_dict_put(old value)");
         pde->value = value;
+        pdict->generation++;
         return 1;
     }
 }
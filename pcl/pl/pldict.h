@@ -49,6 +49,8 @@ struct pl_dict_s
     pl_dict_value_free_proc_t free_proc;
     pl_dict_t *parent;          /* next dictionary up the stack */
     gs_memory_t *memory;
+    uint generation;            /* changes whenever an entry is added,
+                                   replaced or deleted */
 };
 
 #ifdef extern_st
@@ -85,6 +85,7 @@ Options: -dNOPAUSE -E[#] -h -L<PCL|PCLXL> -K<maxK> -l<PCL5C|PCL5E|RTL> -Z...\n\
          -sDEVICE=<dev> -g<W>x<H> -r<X>[x<Y>] -d{First|Last}Page=<#>\n\
          -H<l>x<b>x<r>x<t> -dNOCACHE\n\
          -sOutputFile=<file> (-s<option>=<string> | -d<option>[=<value>])*\n\
+         -sJobOutputFile=<file with %%d for the job number> -sJobLog=<file>\n\
          -J<PJL commands>\n";
 
 /* Simple structure to hold the contents of a buffered file.
@@ -164,6 +165,13 @@ struct pl_main_instance_s
 
     pl_resource_reset reset_resources;
 
+    /* When a stream holds several jobs, -sJobOutputFile gives each job its
+     * own output file, and a result record is written for each job, to
+     * the -sJobLog file if there is one. */
+    char *job_output_file;
+    gp_file *job_log;
+    int job_count;
+
     /* When processing data via 'run_string', interpreters may not
      * completely consume the data they are passed each time. We use
      * this buffer to carry over data between calls. */
@@ -851,6 +859,91 @@ pl_main_run_string_continue(pl_main_instance_t *minst, const char *str, unsigned
     return code;
 }
 
+/* Check that a JobOutputFile template has exactly one integer conversion
+ * (for the job number) and no other conversions but %%. */
+static bool
+job_output_file_is_valid(const char *fname)
+{
+    int conversions = 0;
+
+    for (; *fname; fname++) {
+        if (*fname != '%')
+            continue;
+        if (*++fname == '%')
+            continue;
+        while (*fname == '0' || *fname == '-' || *fname == '+' || *fname == ' ')
+            fname++;
+        while (*fname >= '0' && *fname <= '9')
+            fname++;
+        if (*fname != 'd' && *fname != 'i' && *fname != 'u')
+            return false;
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+/* Direct the device output to the file for the given job. This is done
+ * before the job's interpreter is initialised, while the device is closed
+ * (except for the first job), so that the device opens the job's file. */
+static int
+pl_main_set_job_output_file(pl_main_instance_t *minst, int job)
+{
+    char fname[gp_file_name_sizeof];
+    char arg[gp_file_name_sizeof + 16];
+
+    gs_snprintf(fname, sizeof(fname), minst->job_output_file, job);
+    gs_snprintf(arg, sizeof(arg), "OutputFile=%s", fname);
+    return pl_main_set_string_param(minst, arg);
+}
+
+static int
+pl_main_begin_job(pl_main_instance_t *minst, long *start_page_count)
+{
+    int code = 0;
+
+    minst->job_count++;
+    if (minst->job_output_file)
+        code = pl_main_set_job_output_file(minst, minst->job_count);
+    *start_page_count = minst->device ? minst->device->PageCount : 0;
+    return code;
+}
+
+/* Finish the output of the current job and write its result record. */
+static void
+pl_main_end_job(pl_main_instance_t *minst, pl_interp_implementation_t *impl,
+                int status, long start_page_count)
+{
+    char fname[gp_file_name_sizeof];
+    char record[gp_file_name_sizeof + 128];
+    long pages = minst->device ? minst->device->PageCount - start_page_count : 0;
+    int code;
+
+    if (minst->job_output_file == NULL && minst->job_log == NULL)
+        return;
+    fname[0] = 0;
+    if (minst->job_output_file) {
+        gs_snprintf(fname, sizeof(fname), minst->job_output_file, minst->job_count);
+        /* Close the device so that the job's file is complete by the time
+         * the record says so. This is done after the job's interpreter has
+         * been shut down, as that may itself reopen the device; the next
+         * job's interpreter opens it again on the next job's file. */
+        if (minst->device) {
+            code = gs_closedevice(minst->device);
+            if (code < 0 && status >= 0)
+                status = code;
+        }
+    }
+    gs_snprintf(record, sizeof(record),
+                "%%%%[ Job: %d; Language: %s; Status: %d; Pages: %ld%s%s ]%%%%\n",
+                minst->job_count, pl_characteristics(impl)->language, status,
+                pages, fname[0] ? "; OutputFile: " : "", fname);
+    if (minst->job_log) {
+        gp_fputs(record, minst->job_log);
+        gp_fflush(minst->job_log);
+    } else
+        errprintf(minst->memory, "%s", record);
+}
+
 static int
 pl_main_run_file_utf8(pl_main_instance_t *minst, const char *prefix_commands, const char *filename)
 {
@@ -863,6 +956,10 @@ pl_main_run_file_utf8(pl_main_instance_t *minst, const char *prefix_commands, co
     bool is_stdin = filename[0] == '-' && filename[1] == 0;
     bool use_process_file = false;
     bool first_job = true;
+    bool in_job = false;
+    int job_status = 0;
+    long job_start_page_count = 0;
+    pl_interp_implementation_t *job_impl = NULL;
     pl_interp_implementation_t *desired_implementation = NULL;
 
     if (is_stdin) {
@@ -899,7 +996,12 @@ pl_main_run_file_utf8(pl_main_instance_t *minst, const char *prefix_commands, co
             if (pl_process_end(minst->curr_implementation) < 0)
                  goto error_fatal;
             pl_process_eof(minst->curr_implementation);
-            if (revert_to_pjli(minst) < 0)
+            code = revert_to_pjli(minst);
+            if (in_job) {
+                pl_main_end_job(minst, job_impl, job_status, job_start_page_count);
+                in_job = false;
+            }
+            if (code < 0)
                 goto error_fatal_reverted;
             break;
         }
@@ -931,6 +1033,13 @@ pl_main_run_file_utf8(pl_main_instance_t *minst, const char *prefix_commands, co
 
                 /* If the language implementation needs changing, change it. */
                 if (desired_implementation != pjli) {
+                    /* Start the job before its interpreter opens the device. */
+                    code = pl_main_begin_job(minst, &job_start_page_count);
+                    job_impl = desired_implementation;
+                    in_job = true;
+                    job_status = 0;
+                    if (code < 0)
+                        goto error_fatal;
 
                     /* If we are being asked to swap to a language implementation
                      * that is different to the last (non-PJL) implementation that
@@ -965,6 +1074,15 @@ pl_main_run_file_utf8(pl_main_instance_t *minst, const char *prefix_commands, co
             if (minst->curr_implementation != pjli) {
                 if_debug1m('I', mem, "initialised (%s)\n",
                            pl_characteristics(minst->curr_implementation)->language);
+                if (!in_job) {
+                    /* The language was selected before this call. */
+                    code = pl_main_begin_job(minst, &job_start_page_count);
+                    job_impl = minst->curr_implementation;
+                    in_job = true;
+                    job_status = 0;
+                    if (code < 0)
+                        goto error_fatal;
+                }
                 if (first_job &&
                     !is_stdin &&
                     minst->curr_implementation->proc_process_file) {
@@ -1015,6 +1133,7 @@ flush_to_end_of_job:
             pl_report_errors(minst->curr_implementation, code,
                              sftell(s),
                              minst->error_report > 0);
+            job_status = code;
         }
 
         if (pl_process_end(minst->curr_implementation) < 0)
@@ -1022,7 +1141,12 @@ flush_to_end_of_job:
         new_job = true;
         /* Always revert to PJL after each job. We avoid reinitialising PJL
          * if we are already in PJL to avoid clearing the state. */
-        if (revert_to_pjli(minst))
+        code = revert_to_pjli(minst);
+        if (in_job) {
+            pl_main_end_job(minst, job_impl, job_status, job_start_page_count);
+            in_job = false;
+        }
+        if (code < 0)
             goto error_fatal_reverted;
     }
     sfclose(s);
@@ -1039,8 +1163,12 @@ flush_to_end_of_job:
             errprintf(mem, "Warning interpreter exited with error code %d\n",
                       code);
         }
+        job_status = code;
     }
-    if (revert_to_pjli(minst) < 0)
+    code = revert_to_pjli(minst);
+    if (in_job)
+        pl_main_end_job(minst, job_impl, job_status, job_start_page_count);
+    if (code < 0)
         goto error_fatal_reverted;
     return 0;
 
@@ -1201,6 +1329,10 @@ pl_main_delete_instance(pl_main_instance_t *minst)
 
     drop_buffered_file(minst->buffering_runstring_as_file);
 
+    if (minst->job_log != NULL)
+        gp_fclose(minst->job_log);
+    gs_free_object(mem, minst->job_output_file, "pl_main_instance job_output_file");
+
     gs_free_object(mem, minst->buf_ptr, "minst_buffer");
 
     gs_c_param_list_release(&minst->params);
@@ -2308,6 +2440,28 @@ handle_dash_s(pl_main_instance_t *pmi, const char *arg)
         pmi->pdefault_cmyk_icc = arg_copy(value, pmi->memory);
     } else if (argis(arg, "ICCProfileDir")) {
         pmi->piccdir = arg_copy(value, pmi->memory);
+    } else if (argis(arg, "JobOutputFile")) {
+        if (!job_output_file_is_valid(value)) {
+            dmprintf(pmi->memory,
+                     "JobOutputFile must contain one %%d for the job number\n");
+            return -1;
+        }
+        code = gs_add_outputfile_control_path(pmi->memory, value);
+        if (code < 0)
+            return code;
+        gs_free_object(pmi->memory, pmi->job_output_file, "handle_dash_s");
+        pmi->job_output_file = arg_copy(value, pmi->memory);
+        if (pmi->job_output_file == NULL)
+            return gs_error_VMerror;
+        pmi->pause = false;
+    } else if (argis(arg, "JobLog")) {
+        if (pmi->job_log != NULL)
+            gp_fclose(pmi->job_log);
+        pmi->job_log = gp_fopen(pmi->memory, value, "w");
+        if (pmi->job_log == NULL) {
+            dmprintf1(pmi->memory, "Unable to open JobLog file %s\n", value);
+            return gs_error_undefinedfilename;
+        }
     } else if (argis(arg, "OutputFile") && strlen(eqp) > 0) {
         code = gs_add_outputfile_control_path(pmi->memory, eqp+1);
         if (code < 0)
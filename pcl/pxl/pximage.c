@@ -676,14 +676,21 @@ read_deltarow_bitmap_data(px_bitmap_enum_t * benum, byte ** pdata,
                 }
 
             case partial_cnt:{
+                    /* copy as much of the new data as we have into the row */
+                    byte *prow_end = *pdata + benum->data_per_row;
+                    uint cnt = min(deltarow->short_cnt, avail);
+                    uint room = (pout < prow_end ? prow_end - pout : 0);
+
+                    /* a count already used up wraps, as it always has */
+                    if (deltarow->row_byte_count != 0 && cnt > deltarow->row_byte_count)
+                        cnt = deltarow->row_byte_count;
                     /* check for possible row overflow */
-                    if (pout >= *pdata + benum->data_per_row)
-                        pin++;
-                    else
-                        *pout++ = *pin++;   /* copy new data into row */
-                    avail--;
-                    deltarow->row_byte_count--;
-                    deltarow->short_cnt--;
+                    memcpy(pout, pin, min(cnt, room));
+                    pout += min(cnt, room);
+                    pin += cnt;
+                    avail -= cnt;
+                    deltarow->row_byte_count -= cnt;
+                    deltarow->short_cnt -= cnt;
 
                     if (deltarow->row_byte_count == 0) {
                         end_of_row = true;
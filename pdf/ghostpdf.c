@@ -40,6 +40,7 @@
 #include "pdf_xref.h"
 #include "pdf_device.h"
 #include "pdf_mark.h"
+#include "pdf_image.h"
 
 #include "gsstate.h"        /* For gs_gstate */
 #include "gsicc_manage.h"  /* For gsicc_init_iccmanager() */
@@ -2017,6 +2018,8 @@ int pdfi_clear_context(pdf_context *ctx)
     dmprintf1(ctx->memory, "Normal object cache hit rate: %f\n", hit_rate);
     dmprintf1(ctx->memory, "Compressed object cache hit rate: %f\n", compressed_hit_rate);
 #endif
+    pdfi_purge_image_cache(ctx);
+
     if (ctx->PathSegments != NULL) {
         gs_free_object(ctx->memory, ctx->PathSegments, "pdfi_clear_context");
         ctx->PathSegments = NULL;
@@ -2070,6 +2073,11 @@ int pdfi_clear_context(pdf_context *ctx)
         ctx->args.defaultfont.data = NULL;
     }
 
+    if (ctx->args.nativefontmapcache.data != NULL) {
+        gs_free_object(ctx->memory, ctx->args.nativefontmapcache.data, "nativefontmapcache.data");
+        ctx->args.nativefontmapcache.data = NULL;
+    }
+
     pdfi_free_cstring_array(ctx, &ctx->args.showannottypes);
     pdfi_free_cstring_array(ctx, &ctx->args.preserveannottypes);
 
@@ -2247,6 +2255,9 @@ int pdfi_free_context(pdf_context *ctx)
     }
     rc_decrement(ctx->devbbox, "pdfi_free_context");
 
+    while (ctx->num_free_count > 0)
+        gs_free_object(ctx->memory, ctx->num_free_list[--ctx->num_free_count], "pdfi_free_context");
+
     gs_free_object(ctx->memory, ctx, "pdfi_free_context");
 #if PDFI_LEAK_CHECK
     gs_memory_status(mem, &mstat);
@@ -91,6 +91,7 @@ typedef enum pdf_type3_d_type_e {
 #define MAX_STACK_SIZE 524288
 #define MAX_OBJECT_CACHE_SIZE 200
 #define INITIAL_LOOP_TRACKER_SIZE 32
+#define MAX_NUM_FREE_LIST_SIZE 64
 
 typedef struct pdf_transfer_s {
     gs_mapping_proc proc;	/* typedef is in gxtmap.h */
@@ -120,6 +121,9 @@ struct resource_font_cache_s
     pdf_obj *pdffont;
 };
 
+/* On disk cache of the native font scan, private to pdf_fmap.c */
+typedef struct pdfi_fontscan_cache_s pdfi_fontscan_cache;
+
 typedef struct name_entry_s {
     char *name;
     int len;
@@ -172,6 +176,9 @@ typedef struct cmd_args_s {
 
     bool ignoretounicode;
     bool nonativefontmap;
+    gs_string nativefontmapcache;
+    int image_cache_size;       /* -dImageCacheSize= (bytes, 0 disables) */
+    bool nodctscaling;          /* -dNoDCTScaling, always decode JPEGs at full size */
 } cmd_args_t;
 
 typedef struct encryption_state_s {
@@ -450,6 +457,7 @@ typedef struct pdf_context_s
     pdf_dict *PagesTree;
     uint64_t num_pages;
     uint32_t *page_array; /* cache of page dict object_num's for pdfmark Dest */
+    struct pdfi_page_index_s *page_index; /* page number -> Pages node, built on demand */
     pdf_dict *AcroForm;
     bool NeedAppearances; /* From AcroForm, if any */
 
@@ -459,11 +467,24 @@ typedef struct pdf_context_s
     pdf_obj **stack_top;
     pdf_obj **stack_limit;
 
+    /* Freed number objects kept for reuse, content stream operands are
+     * mostly numbers which are allocated and freed for every operator.
+     * No operator takes more than a few, so the list seldom holds more
+     * than 8; the limit only bounds what a large number array leaves.
+     */
+    uint32_t num_free_count;
+    pdf_obj *num_free_list[MAX_NUM_FREE_LIST_SIZE];
+
     /* The object cache */
     uint32_t cache_entries;
     pdf_obj_cache_entry *cache_LRU;
     pdf_obj_cache_entry *cache_MRU;
 
+    /* The decoded image data cache */
+    uint64_t image_cache_used;
+    pdfi_image_cache_entry *image_cache_LRU;
+    pdfi_image_cache_entry *image_cache_MRU;
+
     /* The loop detection state */
     uint32_t loop_detection_size;
     uint32_t loop_detection_entries;
@@ -492,6 +513,7 @@ typedef struct pdf_context_s
     search_paths_t search_paths;
     pdf_dict *pdffontmap;
     pdf_dict *pdfnativefontmap; /* Explicit mappings take precedence, hence we need separate dictionaries */
+    pdfi_fontscan_cache *fontscan_cache; /* Only exists while pdfnativefontmap is being built */
     pdf_dict *pdf_substitute_fonts;
     pdf_dict *pdfcidfmap;
     resource_font_cache_t *resource_font_cache;
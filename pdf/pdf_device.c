@@ -60,6 +60,26 @@ bool pdfi_device_check_param_bool(gx_device *dev, const char *param)
     return (bool)value;
 }
 
+/* Check value of integer device parameter, 0 if the device doesn't have it */
+int pdfi_device_check_param_int(gx_device *dev, const char *param)
+{
+    int code;
+    gs_c_param_list list;
+    int value;
+
+    code = pdfi_device_check_param(dev, param, &list);
+    if (code < 0)
+        return 0;
+    gs_c_param_list_read(&list);
+    code = param_read_int((gs_param_list *)&list,
+                          param,
+                          &value);
+    if (code != 0)
+        value = 0;
+    gs_c_param_list_release(&list);
+    return value;
+}
+
 /* Set value of string device parameter */
 int pdfi_device_set_param_string(gx_device *dev, const char *paramname, const char *value)
 {
@@ -18,6 +18,7 @@
 
 int pdfi_device_check_param(gx_device *dev, const char *param, gs_c_param_list *list);
 bool pdfi_device_check_param_bool(gx_device *dev, const char *param);
+int pdfi_device_check_param_int(gx_device *dev, const char *param);
 bool pdfi_device_check_param_exists(gx_device *dev, const char *param);
 int pdfi_device_set_param_string(gx_device *dev, const char *paramname, const char *value);
 int pdfi_device_set_param_bool(gx_device *dev, const char *param, bool value);
@@ -26,6 +26,8 @@
 
 static int pdfi_dict_find(pdf_context *ctx, pdf_dict *d, const char *Key, bool sort);
 static int pdfi_dict_find_key(pdf_context *ctx, pdf_dict *d, const pdf_name *Key, bool sort);
+static int pdfi_dict_hash_build(gs_memory_t *mem, pdf_dict *d);
+static void pdfi_dict_hash_added(pdf_context *ctx, pdf_dict *d, uint64_t i);
 
 void pdfi_free_dict(pdf_obj *o)
 {
@@ -45,6 +47,7 @@ void pdfi_free_dict(pdf_obj *o)
             pdfi_countdown(d->list[i].key);
     }
     gs_free_object(OBJ_MEMORY(d), d->list, "pdf interpreter free dictionary key/values");
+    gs_free_object(OBJ_MEMORY(d), d->hash, "pdf interpreter free dictionary hash");
     gs_free_object(OBJ_MEMORY(d), d, "pdf interpreter free dictionary");
 }
 
@@ -73,6 +76,11 @@ static int pdfi_dict_delete_inner(pdf_context *ctx, pdf_dict *d, pdf_name *n, co
     d->list[d->entries].key = NULL;
     d->list[d->entries].value = NULL;
     d->is_sorted = false;
+    /* The entries after the deleted one have moved, so re-index them. If that
+     * fails the dictionary is simply searched without an index.
+     */
+    if (d->hash != NULL)
+        (void)pdfi_dict_hash_build(ctx->memory, d);
     return 0;
 }
 
@@ -228,12 +236,17 @@ static int pdfi_dict_compare_entry(const void *a, const void *b)
     if (key_a->length != key_b->length)
         return key_a->length - key_b->length;
 
-    return strncmp((const char *)key_a->data, (const char *)key_b->data, key_a->length);
+    return memcmp(key_a->data, key_b->data, key_a->length);
 }
 
-static int pdfi_dict_find_sorted(pdf_context *ctx, pdf_dict *d, const char *Key)
+/* The searches below work directly on the bytes of the key, so that a lookup by
+ * pdf_name does not need to make a NULL terminated copy of the name first. Keys
+ * are compared by length before their contents, and a key which is the very same
+ * name object as the one in the dictionary matches without comparing at all.
+ */
+static int pdfi_dict_find_sorted(pdf_context *ctx, pdf_dict *d, const byte *Key, uint32_t keylen)
 {
-    int start = 0, end = d->size - 1, middle = 0, keylen = strlen(Key);
+    int start = 0, end = d->size - 1, middle = 0;
     pdf_name *test_key;
 
     while (start <= end) {
@@ -247,7 +260,7 @@ static int pdfi_dict_find_sorted(pdf_context *ctx, pdf_dict *d, const char *Key)
         }
 
         if (test_key->length == keylen) {
-            int result = strncmp((const char *)test_key->data, Key, keylen);
+            int result = test_key->data == Key ? 0 : memcmp(test_key->data, Key, keylen);
 
             if (result == 0)
                 return middle;
@@ -265,7 +278,7 @@ static int pdfi_dict_find_sorted(pdf_context *ctx, pdf_dict *d, const char *Key)
     return gs_note_error(gs_error_undefined);
 }
 
-static int pdfi_dict_find_unsorted(pdf_context *ctx, pdf_dict *d, const char *Key)
+static int pdfi_dict_find_unsorted(pdf_context *ctx, pdf_dict *d, const byte *Key, uint32_t keylen)
 {
     int i;
     pdf_name *t;
@@ -273,44 +286,128 @@ static int pdfi_dict_find_unsorted(pdf_context *ctx, pdf_dict *d, const char *Ke
     for (i=0;i< d->entries;i++) {
         t = (pdf_name *)d->list[i].key;
 
-        if (t && pdfi_type_of(t) == PDF_NAME) {
-            if (pdfi_name_is((pdf_name *)t, Key)) {
+        if (t && pdfi_type_of(t) == PDF_NAME && t->length == keylen) {
+            if (t->data == Key || memcmp(t->data, Key, keylen) == 0)
                 return i;
-            }
         }
     }
     return_error(gs_error_undefined);
 }
 
-static int pdfi_dict_find(pdf_context *ctx, pdf_dict *d, const char *Key, bool sort)
+/* Large dictionaries (more than PDFI_DICT_HASH_THRESHOLD entries) are given a
+ * hash index the first time they are searched by a lookup, rather than while they
+ * are being built (when 'sort' is false). The index is an open addressed table
+ * of list indices, at most half full, kept up to date by pdfi_dict_put_obj,
+ * pdfi_dict_put_unchecked and pdfi_dict_delete_inner. If we can't allocate it
+ * we fall back to sorting the dictionary and using a binary search, as before.
+ */
+#define PDFI_DICT_HASH_THRESHOLD 32
+
+static uint32_t pdfi_dict_hash_bytes(const byte *p, uint32_t len)
+{
+    uint32_t h = 2166136261U;
+
+    while (len--) {
+        h ^= *p++;
+        h *= 16777619U;
+    }
+    return h;
+}
+
+static void pdfi_dict_hash_insert(pdf_dict *d, uint64_t i)
+{
+    pdf_name *key = (pdf_name *)d->list[i].key;
+    uint32_t mask = d->hash_size - 1;
+    uint32_t h = pdfi_dict_hash_bytes(key->data, key->length) & mask;
+
+    while (d->hash[h] != 0)
+        h = (h + 1) & mask;
+    d->hash[h] = (uint32_t)i + 1;
+}
+
+/* (Re)build the index of all the keys in the dictionary. On failure the
+ * dictionary is left without one.
+ */
+static int pdfi_dict_hash_build(gs_memory_t *mem, pdf_dict *d)
+{
+    uint32_t size = 64;
+    uint64_t i;
+
+    gs_free_object(mem, d->hash, "pdfi_dict_hash_build");
+    d->hash = NULL;
+    d->hash_size = 0;
+
+    while (size < d->size * 2) {
+        if (size >= (1U << 30))
+            return_error(gs_error_limitcheck);
+        size <<= 1;
+    }
+    d->hash = (uint32_t *)gs_alloc_bytes(mem, size * sizeof(uint32_t), "pdfi_dict_hash_build");
+    if (d->hash == NULL)
+        return_error(gs_error_VMerror);
+    memset(d->hash, 0x00, size * sizeof(uint32_t));
+    d->hash_size = size;
+
+    for (i = 0; i < d->size; i++) {
+        if (d->list[i].key != NULL)
+            pdfi_dict_hash_insert(d, i);
+    }
+    return 0;
+}
+
+/* A new key has been stored in list[i] */
+static void pdfi_dict_hash_added(pdf_context *ctx, pdf_dict *d, uint64_t i)
+{
+    if (d->hash == NULL)
+        return;
+    if (d->size * 2 > d->hash_size)
+        (void)pdfi_dict_hash_build(ctx->memory, d);
+    else
+        pdfi_dict_hash_insert(d, i);
+}
+
+static int pdfi_dict_find_hashed(pdf_context *ctx, pdf_dict *d, const byte *Key, uint32_t keylen)
+{
+    uint32_t mask = d->hash_size - 1;
+    uint32_t h = pdfi_dict_hash_bytes(Key, keylen) & mask;
+    pdf_name *t;
+
+    while (d->hash[h] != 0) {
+        t = (pdf_name *)d->list[d->hash[h] - 1].key;
+        if (t->length == keylen && (t->data == Key || memcmp(t->data, Key, keylen) == 0))
+            return d->hash[h] - 1;
+        h = (h + 1) & mask;
+    }
+    return gs_note_error(gs_error_undefined);
+}
+
+static int pdfi_dict_find_bytes(pdf_context *ctx, pdf_dict *d, const byte *Key, uint32_t keylen, bool sort)
 {
+    if (d->hash != NULL)
+        return pdfi_dict_find_hashed(ctx, d, Key, keylen);
+
     if (!d->is_sorted) {
-        if (d->entries > 32 && sort) {
+        if (d->entries > PDFI_DICT_HASH_THRESHOLD && sort) {
+            /* Sort as well, so that the order of the entries is as it always was */
             qsort(d->list, d->size, sizeof(pdf_dict_entry), pdfi_dict_compare_entry);
             d->is_sorted = true;
-            return pdfi_dict_find_sorted(ctx, d, Key);
+            if (pdfi_dict_hash_build(ctx->memory, d) >= 0)
+                return pdfi_dict_find_hashed(ctx, d, Key, keylen);
+            return pdfi_dict_find_sorted(ctx, d, Key, keylen);
         } else
-            return pdfi_dict_find_unsorted(ctx, d, Key);
+            return pdfi_dict_find_unsorted(ctx, d, Key, keylen);
     } else
-        return pdfi_dict_find_sorted(ctx, d, Key);
+        return pdfi_dict_find_sorted(ctx, d, Key, keylen);
 }
 
-static int pdfi_dict_find_key(pdf_context *ctx, pdf_dict *d, const pdf_name *Key, bool sort)
+static int pdfi_dict_find(pdf_context *ctx, pdf_dict *d, const char *Key, bool sort)
 {
-    char *Test = NULL;
-    int index = 0;
-
-    Test = (char *)gs_alloc_bytes(ctx->memory, Key->length + 1, "pdfi_dict_find_key");
-    if (Test == NULL)
-        return_error(gs_error_VMerror);
-
-    memcpy(Test, Key->data, Key->length);
-    Test[Key->length] = 0x00;
-
-    index = pdfi_dict_find(ctx, d, Test, sort);
+    return pdfi_dict_find_bytes(ctx, d, (const byte *)Key, strlen(Key), sort);
+}
 
-    gs_free_object(ctx->memory, Test, "pdfi_dict_find_key");
-    return index;
+static int pdfi_dict_find_key(pdf_context *ctx, pdf_dict *d, const pdf_name *Key, bool sort)
+{
+    return pdfi_dict_find_bytes(ctx, d, Key->data, Key->length, sort);
 }
 
 /* The object returned by pdfi_dict_get has its reference count incremented by 1 to
@@ -903,6 +1000,7 @@ int pdfi_dict_put_obj(pdf_context *ctx, pdf_dict *d, pdf_obj *Key, pdf_obj *valu
                 d->list[i].value = value;
                 pdfi_countup(value);
                 d->entries++;
+                pdfi_dict_hash_added(ctx, d, i);
                 return 0;
             }
         }
@@ -924,6 +1022,7 @@ int pdfi_dict_put_obj(pdf_context *ctx, pdf_dict *d, pdf_obj *Key, pdf_obj *valu
     d->entries++;
     pdfi_countup(Key);
     pdfi_countup(value);
+    pdfi_dict_hash_added(ctx, d, d->size - 1);
 
     return 0;
 }
@@ -959,6 +1058,7 @@ int pdfi_dict_put_unchecked(pdf_context *ctx, pdf_dict *d, const char *Key, pdf_
                     d->list[i].value = value;
                     pdfi_countup(value);
                     d->entries++;
+                    pdfi_dict_hash_added(ctx, d, i);
                     return 0;
                 }
             }
@@ -985,6 +1085,7 @@ int pdfi_dict_put_unchecked(pdf_context *ctx, pdf_dict *d, const char *Key, pdf_
     d->size++;
     d->entries++;
     pdfi_countup(value);
+    pdfi_dict_hash_added(ctx, d, d->size - 1);
 
     return 0;
 }
@@ -895,6 +895,307 @@ int pdfi_get_page_dict(pdf_context *ctx, pdf_dict *d, uint64_t page_num, uint64_
     return code;
 }
 
+/* Page index.
+ * pdfi_get_page_dict() walks the Pages tree from the root on every call,
+ * scanning each Kids array on the way down, so visiting every page of a
+ * document with a flat tree takes time quadratic in the number of pages.
+ * The index records, for each page, the Pages node which holds it and its
+ * position in that node's Kids array, along with the inheritable keys in
+ * effect at the node. It is filled in by a single depth first pass over the
+ * tree, which is only advanced as far as the highest page asked for so far,
+ * and which (like the tree walk) uses /Count to skip subtrees lying wholly
+ * before that page. Pages the pass skipped, and all pages if the pass fails,
+ * are found by walking the tree as before.
+ */
+typedef struct {
+    pdf_array *Kids;
+    pdf_dict *inheritable;      /* inheritable keys in effect below this node */
+    uint32_t object_num;        /* for loop detection */
+    uint64_t next_kid;          /* next entry in Kids for the pass to visit */
+    uint64_t end_page;          /* first page number after this node, from /Count */
+} pdfi_page_node;
+
+typedef struct pdfi_page_index_s {
+    uint32_t *page_node;        /* 1 + index in nodes, or 0 if the page is not indexed */
+    uint32_t *page_kid;         /* index of the page in its node's Kids */
+    pdfi_page_node *nodes;
+    uint32_t num_nodes;
+    uint32_t max_nodes;
+    uint32_t *path;             /* nodes from the root to the one being scanned */
+    uint32_t depth;
+    uint64_t next_page;         /* number of the next page the pass will find */
+    bool done;                  /* pass finished, or abandoned on an error */
+} pdfi_page_index;
+
+/* Get the /Count of a Pages node, checked as pdfi_get_page_dict() does */
+static int pdfi_page_index_count(pdf_context *ctx, pdf_dict *d, uint64_t start, int64_t *num)
+{
+    double dbl;
+    int code;
+
+    code = pdfi_dict_get_number(ctx, d, "Count", &dbl);
+    if (code < 0)
+        return code;
+    if (dbl != floor(dbl))
+        return_error(gs_error_rangecheck);
+    *num = (int)dbl;
+    if (*num < 0 || (*num + start) > ctx->num_pages)
+        return_error(gs_error_rangecheck);
+    return 0;
+}
+
+static int pdfi_page_index_grow(pdf_context *ctx, pdfi_page_index *idx)
+{
+    uint32_t max_nodes = idx->max_nodes == 0 ? 16 : idx->max_nodes * 2;
+    pdfi_page_node *nodes;
+    uint32_t *path;
+
+    if (max_nodes < idx->max_nodes)
+        return_error(gs_error_limitcheck);
+    nodes = (pdfi_page_node *)gs_alloc_bytes(ctx->memory, (size_t)max_nodes * sizeof(pdfi_page_node),
+                                             "pdfi_page_index_grow(nodes)");
+    path = (uint32_t *)gs_alloc_bytes(ctx->memory, (size_t)max_nodes * sizeof(uint32_t),
+                                      "pdfi_page_index_grow(path)");
+    if (nodes == NULL || path == NULL) {
+        gs_free_object(ctx->memory, nodes, "pdfi_page_index_grow(nodes)");
+        gs_free_object(ctx->memory, path, "pdfi_page_index_grow(path)");
+        return_error(gs_error_VMerror);
+    }
+    if (idx->num_nodes > 0) {
+        memcpy(nodes, idx->nodes, idx->num_nodes * sizeof(pdfi_page_node));
+        memcpy(path, idx->path, idx->depth * sizeof(uint32_t));
+    }
+    gs_free_object(ctx->memory, idx->nodes, "pdfi_page_index_grow(nodes)");
+    gs_free_object(ctx->memory, idx->path, "pdfi_page_index_grow(path)");
+    idx->nodes = nodes;
+    idx->path = path;
+    idx->max_nodes = max_nodes;
+    return 0;
+}
+
+/* Add a Pages node whose first page is idx->next_page, and descend into it */
+static int pdfi_page_index_push(pdf_context *ctx, pdfi_page_index *idx, pdf_dict *d,
+                                pdf_dict *inherited, int64_t num)
+{
+    pdfi_page_node *node;
+    uint32_t i;
+    int code;
+
+    if (d->object_num != 0) {
+        for (i = 0; i < idx->depth; i++) {
+            if (idx->nodes[idx->path[i]].object_num == d->object_num)
+                return_error(gs_error_circular_reference);
+        }
+    }
+    if (idx->num_nodes == idx->max_nodes) {
+        code = pdfi_page_index_grow(ctx, idx);
+        if (code < 0)
+            return code;
+    }
+    node = &idx->nodes[idx->num_nodes];
+    node->Kids = NULL;
+    code = pdfi_dict_alloc(ctx, 0, &node->inheritable);
+    if (code < 0)
+        return code;
+    pdfi_countup(node->inheritable);
+    idx->num_nodes++;
+
+    if (inherited != NULL) {
+        code = pdfi_dict_copy(ctx, node->inheritable, inherited);
+        if (code < 0)
+            return code;
+    }
+    code = pdfi_check_inherited_key(ctx, d, "Resources", node->inheritable);
+    if (code < 0)
+        return code;
+    code = pdfi_check_inherited_key(ctx, d, "MediaBox", node->inheritable);
+    if (code < 0)
+        return code;
+    code = pdfi_check_inherited_key(ctx, d, "CropBox", node->inheritable);
+    if (code < 0)
+        return code;
+    code = pdfi_check_inherited_key(ctx, d, "Rotate", node->inheritable);
+    if (code < 0)
+        return code;
+    code = pdfi_dict_get_type(ctx, d, "Kids", PDF_ARRAY, (pdf_obj **)&node->Kids);
+    if (code < 0)
+        return code;
+
+    node->object_num = d->object_num;
+    node->next_kid = 0;
+    node->end_page = idx->next_page + num;
+    idx->path[idx->depth++] = idx->num_nodes - 1;
+    return 0;
+}
+
+/* Continue the pass until page_num has been indexed or skipped */
+static void pdfi_page_index_advance(pdf_context *ctx, pdfi_page_index *idx, uint64_t page_num)
+{
+    pdf_dict *child = NULL;
+    pdf_name *Type = NULL;
+    int64_t num;
+    int code = 0;
+
+    while (!idx->done && idx->next_page <= page_num) {
+        uint32_t n = idx->path[idx->depth - 1];
+        pdfi_page_node *node = &idx->nodes[n];
+        uint64_t i;
+
+        if (node->next_kid >= pdfi_array_size(node->Kids) || idx->next_page >= node->end_page) {
+            /* Page numbers carry on from the node's /Count, as in the tree walk */
+            idx->next_page = node->end_page;
+            if (--idx->depth == 0)
+                idx->done = true;
+            continue;
+        }
+        i = node->next_kid++;
+
+        code = pdfi_loop_detector_mark(ctx);
+        if (code < 0)
+            break;
+        code = pdfi_get_child(ctx, node->Kids, i, &child);
+        if (code >= 0)
+            code = pdfi_dict_get_type(ctx, child, "Type", PDF_NAME, (pdf_obj **)&Type);
+        if (code >= 0) {
+            if (pdfi_name_is(Type, "Pages")) {
+                code = pdfi_page_index_count(ctx, child, idx->next_page, &num);
+                if (code >= 0) {
+                    if (num + idx->next_page <= page_num)
+                        idx->next_page += num;
+                    else
+                        code = pdfi_page_index_push(ctx, idx, child, node->inheritable, num);
+                }
+            } else {
+                if (!pdfi_name_is(Type, "PageRef") && !pdfi_name_is(Type, "Page"))
+                    pdfi_set_error(ctx, 0, NULL, E_PDF_BADPAGETYPE, "pdfi_page_index_advance", NULL);
+                idx->page_node[idx->next_page] = n + 1;
+                idx->page_kid[idx->next_page] = (uint32_t)i;
+                idx->next_page++;
+            }
+        }
+        (void)pdfi_loop_detector_cleartomark(ctx);
+        pdfi_countdown(child);
+        child = NULL;
+        pdfi_countdown(Type);
+        Type = NULL;
+        if (code < 0)
+            break;
+    }
+    /* Leave any errors to be reported by the tree walk */
+    if (code < 0)
+        idx->done = true;
+}
+
+static int pdfi_page_index_init(pdf_context *ctx)
+{
+    pdfi_page_index *idx;
+    size_t size = ctx->num_pages * sizeof(uint32_t);
+    int64_t num;
+    int code;
+
+    idx = (pdfi_page_index *)gs_alloc_bytes(ctx->memory, sizeof(pdfi_page_index),
+                                            "pdfi_page_index_init(index)");
+    if (idx == NULL)
+        return_error(gs_error_VMerror);
+    memset(idx, 0, sizeof(pdfi_page_index));
+    ctx->page_index = idx;
+
+    idx->page_node = (uint32_t *)gs_alloc_bytes(ctx->memory, size, "pdfi_page_index_init(page_node)");
+    idx->page_kid = (uint32_t *)gs_alloc_bytes(ctx->memory, size, "pdfi_page_index_init(page_kid)");
+    if (idx->page_node == NULL || idx->page_kid == NULL) {
+        idx->done = true;
+        return_error(gs_error_VMerror);
+    }
+    memset(idx->page_node, 0, size);
+
+    code = pdfi_loop_detector_mark(ctx);
+    if (code < 0) {
+        idx->done = true;
+        return code;
+    }
+    code = pdfi_page_index_count(ctx, ctx->PagesTree, 0, &num);
+    if (code >= 0)
+        code = pdfi_page_index_push(ctx, idx, ctx->PagesTree, NULL, num);
+    (void)pdfi_loop_detector_cleartomark(ctx);
+    if (code < 0)
+        idx->done = true;
+    return 0;
+}
+
+static void pdfi_page_index_free(pdf_context *ctx)
+{
+    pdfi_page_index *idx = ctx->page_index;
+    uint32_t i;
+
+    if (idx == NULL)
+        return;
+    for (i = 0; i < idx->num_nodes; i++) {
+        pdfi_countdown(idx->nodes[i].Kids);
+        pdfi_countdown(idx->nodes[i].inheritable);
+    }
+    gs_free_object(ctx->memory, idx->nodes, "pdfi_page_index_free(nodes)");
+    gs_free_object(ctx->memory, idx->path, "pdfi_page_index_free(path)");
+    gs_free_object(ctx->memory, idx->page_node, "pdfi_page_index_free(page_node)");
+    gs_free_object(ctx->memory, idx->page_kid, "pdfi_page_index_free(page_kid)");
+    gs_free_object(ctx->memory, idx, "pdfi_page_index_free(index)");
+    ctx->page_index = NULL;
+}
+
+/* Find a page dictionary using the page index, merging in its inherited keys.
+ * Returns 1 if the page is not in the index, in which case the caller should
+ * fall back to pdfi_get_page_dict().
+ */
+int pdfi_doc_page_index_get(pdf_context *ctx, uint64_t page_num, pdf_dict **target)
+{
+    pdfi_page_index *idx;
+    pdfi_page_node *node;
+    pdf_dict *child = NULL;
+    pdf_dict *page_dict = NULL;
+    pdf_name *Type = NULL;
+    int code;
+
+    if (ctx->PagesTree == NULL || page_num >= ctx->num_pages)
+        return 1;
+    if (ctx->page_index == NULL && pdfi_page_index_init(ctx) < 0)
+        return 1;
+    idx = ctx->page_index;
+    if (idx->page_node == NULL || idx->page_kid == NULL)
+        return 1;
+    if (idx->page_node[page_num] == 0)
+        pdfi_page_index_advance(ctx, idx, page_num);
+    if (idx->page_node[page_num] == 0)
+        return 1;
+    node = &idx->nodes[idx->page_node[page_num] - 1];
+
+    code = pdfi_loop_detector_mark(ctx);
+    if (code < 0)
+        return code;
+    code = pdfi_get_child(ctx, node->Kids, idx->page_kid[page_num], &child);
+    if (code < 0)
+        goto exit;
+    code = pdfi_dict_get_type(ctx, child, "Type", PDF_NAME, (pdf_obj **)&Type);
+    if (code < 0)
+        goto exit;
+    if (pdfi_name_is(Type, "PageRef")) {
+        code = pdfi_dict_get(ctx, child, "PageRef", (pdf_obj **)&page_dict);
+        if (code < 0)
+            goto exit;
+    } else {
+        page_dict = child;
+        pdfi_countup(page_dict);
+    }
+    code = pdfi_merge_dicts(ctx, page_dict, node->inheritable);
+    *target = page_dict;
+    pdfi_countup(*target);
+
+ exit:
+    (void)pdfi_loop_detector_cleartomark(ctx);
+    pdfi_countdown(page_dict);
+    pdfi_countdown(child);
+    pdfi_countdown(Type);
+    return code;
+}
+
 int pdfi_doc_page_array_init(pdf_context *ctx)
 {
     size_t size = ctx->num_pages*sizeof(uint32_t);
@@ -910,6 +1211,7 @@ int pdfi_doc_page_array_init(pdf_context *ctx)
 
 void pdfi_doc_page_array_free(pdf_context *ctx)
 {
+    pdfi_page_index_free(ctx);
     if (!ctx->page_array)
         return;
     gs_free_object(ctx->memory, ctx->page_array, "pdfi_doc_page_array_free(page_array)");
@@ -28,6 +28,7 @@ int pdfi_find_resource(pdf_context *ctx, unsigned char *Type, pdf_name *name, pd
                        pdf_dict *page_dict, pdf_obj **o);
 int pdfi_doc_page_array_init(pdf_context *ctx);
 void pdfi_doc_page_array_free(pdf_context *ctx);
+int pdfi_doc_page_index_get(pdf_context *ctx, uint64_t page_num, pdf_dict **target);
 int pdfi_doc_trailer(pdf_context *ctx);
 
 #endif
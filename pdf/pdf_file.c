@@ -22,6 +22,7 @@
 #include "pdf_array.h"
 #include "pdf_misc.h"
 #include "pdf_sec.h"
+#include "pdf_device.h"
 #include "stream.h"
 #include "strimpl.h"
 #include "strmio.h"
@@ -559,6 +560,8 @@ pdfi_JPX_filter(pdf_context *ctx, pdf_dict *dict, pdf_dict *decode,
         state.PassThrough = 0;
         state.device = (void *)NULL;
     }
+    /* Decode with as many threads as the device renders with */
+    state.NumThreads = pdfi_device_check_param_int(dev, "NumRenderingThreads");
 
     code = pdfi_filter_open(min_size, &s_filter_read_procs, (const stream_template *)&s_jpxd_template,
                             (const stream_state *)&state, ctx->memory->non_gc_memory, new_stream);
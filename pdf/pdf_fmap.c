@@ -17,6 +17,8 @@
 #include "strmio.h"
 #include "stream.h"
 #include "scanchar.h"
+#include "stat_.h"
+#include "gpmisc.h"
 
 #include "pdf_int.h"
 #include "pdf_types.h"
@@ -260,6 +262,8 @@ static int pdfi_font_scan_type_picker(byte *buf, int64_t buflen)
 #undef MAKEMAGIC
 }
 
+static void pdfi_fontscan_cache_record(pdfi_fontscan_cache *cache, const char *fontname, const char *filepath, int index);
+
 static int pdfi_add__to_native_fontmap(pdf_context *ctx, const char *fontname, const char *filepath, const int index)
 {
     int code;
@@ -322,9 +326,369 @@ static int pdfi_add__to_native_fontmap(pdf_context *ctx, const char *fontname, c
         pdfi_countdown(recdict);
     }
 
+    if (code >= 0 && ctx->fontscan_cache != NULL)
+        pdfi_fontscan_cache_record(ctx->fontscan_cache, fontname, filepath, index);
+
+    return code;
+}
+
+/* Native font scan cache (-sNativeFontMapCache=file).
+ * Scanning the font directories means opening and parsing every file in them,
+ * which on systems with a lot of fonts takes long enough to notice. So we can
+ * remember the outcome of a scan in a file, one line for each font found:
+ *
+ *     <file size> <file mtime> <index> <font name>\t<file path>\n
+ *
+ * A file holding no font we recognise gets a single line with an index of -2
+ * and an empty name, so that we don't open it again either. On the next scan a
+ * file whose size and modification time still match its lines in the cache is
+ * not opened; the fonts are taken from the cache instead. Files which are new
+ * or have changed are scanned as normal.
+ *
+ * At the end of the scan the cache is rewritten from the old lines for files
+ * which were still valid, plus the lines for files which had to be scanned,
+ * with duplicates (a file reached through more than one font path) removed.
+ * It is written to a uniquely named scratch file next to the cache and then
+ * renamed over it, so concurrent runs never see, or produce, a partial file.
+ */
+#define FONTSCAN_NO_FONT -2
+
+typedef struct pdfi_fontscan_record_s {
+    const char *path;
+    const char *name;
+    int64_t size;
+    int64_t mtime;
+    int index;
+    bool used;                       /* Old records: file unchanged, keep the record */
+} pdfi_fontscan_record;
+
+struct pdfi_fontscan_cache_s {
+    gs_memory_t *memory;
+    char *fname;                     /* The cache file */
+    byte *buf;                       /* The old cache file, old records point into this */
+    pdfi_fontscan_record *records;   /* Records from the old cache, sorted by path */
+    int count;
+    pdfi_fontscan_record *found;     /* Records for the files we had to scan */
+    int num_found;
+    int max_found;
+    int64_t cur_size;                /* Size and mtime of the font file being scanned, */
+    int64_t cur_mtime;               /* cur_size is -1 if we are not scanning one */
+    bool cur_recorded;
+};
+
+static int pdfi_fontscan_compare_record(const void *a, const void *b)
+{
+    const pdfi_fontscan_record *ra = (const pdfi_fontscan_record *)a, *rb = (const pdfi_fontscan_record *)b;
+    int c = strcmp(ra->path, rb->path);
+
+    if (c == 0)
+        c = ra->index - rb->index;
+    return c;
+}
+
+static int pdfi_fontscan_compare_record_ptr(const void *a, const void *b)
+{
+    return pdfi_fontscan_compare_record(*(const pdfi_fontscan_record **)a, *(const pdfi_fontscan_record **)b);
+}
+
+/* Called for each font found while scanning a file. Fonts added from the cache, or
+ * from anywhere other than the directory scan, are not recorded (cur_size is -1).
+ */
+static void pdfi_fontscan_cache_record(pdfi_fontscan_cache *cache, const char *fontname, const char *filepath, int index)
+{
+    pdfi_fontscan_record *r;
+    const char *p;
+    size_t namelen, pathlen;
+    char *str;
+
+    if (cache->cur_size < 0)
+        return;
+
+    for (p = fontname; *p != '\0'; p++)
+        if (*p == '\t' || *p == '\n' || *p == '\r')
+            return;
+    for (p = filepath; *p != '\0'; p++)
+        if (*p == '\n' || *p == '\r')
+            return;
+
+    if (cache->num_found == cache->max_found) {
+        int max_found = cache->max_found == 0 ? 64 : cache->max_found * 2;
+        pdfi_fontscan_record *found;
+
+        found = (pdfi_fontscan_record *)gs_alloc_bytes(cache->memory, max_found * sizeof(pdfi_fontscan_record), "pdfi_fontscan_cache_record");
+        if (found == NULL)
+            return;
+        if (cache->num_found > 0)
+            memcpy(found, cache->found, cache->num_found * sizeof(pdfi_fontscan_record));
+        gs_free_object(cache->memory, cache->found, "pdfi_fontscan_cache_record");
+        cache->found = found;
+        cache->max_found = max_found;
+    }
+
+    namelen = strlen(fontname);
+    pathlen = strlen(filepath);
+    str = (char *)gs_alloc_bytes(cache->memory, namelen + pathlen + 2, "pdfi_fontscan_cache_record");
+    if (str == NULL)
+        return;
+    memcpy(str, fontname, namelen + 1);
+    memcpy(str + namelen + 1, filepath, pathlen + 1);
+
+    r = &cache->found[cache->num_found++];
+    r->name = str;
+    r->path = str + namelen + 1;
+    r->size = cache->cur_size;
+    r->mtime = cache->cur_mtime;
+    r->index = index;
+    r->used = true;
+    cache->cur_recorded = true;
+}
+
+static int64_t pdfi_fontscan_read_int(char **pp)
+{
+    char *p = *pp;
+    int64_t v = 0;
+    bool neg = false;
+
+    while (*p == ' ')
+        p++;
+    if (*p == '-') {
+        neg = true;
+        p++;
+    }
+    while (*p >= '0' && *p <= '9')
+        v = v * 10 + (*p++ - '0');
+    *pp = p;
+    return neg ? -v : v;
+}
+
+/* Split the old cache file into records. Anything we don't understand, including
+ * a truncated final line, is simply dropped, the files concerned will be scanned.
+ */
+static int pdfi_fontscan_cache_parse(pdfi_fontscan_cache *cache, int64_t len)
+{
+    char *p = (char *)cache->buf, *end = (char *)cache->buf + len, *eol, *tab;
+    int lines = 0, n = 0;
+    pdfi_fontscan_record *r;
+
+    for (eol = p; eol < end; eol++)
+        if (*eol == '\n')
+            lines++;
+    if (lines == 0)
+        return 0;
+
+    cache->records = (pdfi_fontscan_record *)gs_alloc_bytes(cache->memory, lines * sizeof(pdfi_fontscan_record), "pdfi_fontscan_cache_parse");
+    if (cache->records == NULL)
+        return_error(gs_error_VMerror);
+
+    for (; p < end && n < lines; p = eol + 1) {
+        eol = memchr(p, '\n', end - p);
+        if (eol == NULL)
+            break;
+        *eol = '\0';
+        tab = strchr(p, '\t');
+        if (tab == NULL || tab[1] == '\0')
+            continue;
+        *tab = '\0';
+        r = &cache->records[n];
+        r->size = pdfi_fontscan_read_int(&p);
+        r->mtime = pdfi_fontscan_read_int(&p);
+        r->index = (int)pdfi_fontscan_read_int(&p);
+        if (*p == ' ')
+            p++;
+        else if (p != tab)
+            continue;
+        r->name = p;
+        r->path = tab + 1;
+        r->used = false;
+        n++;
+    }
+    cache->count = n;
+    qsort(cache->records, n, sizeof(pdfi_fontscan_record), pdfi_fontscan_compare_record);
+    return 0;
+}
+
+static int pdfi_fontscan_cache_begin(pdf_context *ctx)
+{
+    pdfi_fontscan_cache *cache;
+    const char *fname = (const char *)ctx->args.nativefontmapcache.data;
+    int fnamelen = ctx->args.nativefontmapcache.size;
+    gp_file *in;
+    int code = 0;
+
+    /* The new cache is written next to the old one and renamed over it, which
+     * needs a scratch file in the same directory, and so an absolute path.
+     */
+    if (!gp_file_name_is_absolute(fname, fnamelen)) {
+        errprintf(ctx->memory, "NativeFontMapCache %.*s is not an absolute path, the font scan cache will not be used.\n", fnamelen, fname);
+        return 0;
+    }
+
+    cache = (pdfi_fontscan_cache *)gs_alloc_bytes(ctx->memory, sizeof(pdfi_fontscan_cache), "pdfi_fontscan_cache_begin");
+    if (cache == NULL)
+        return_error(gs_error_VMerror);
+    memset(cache, 0x00, sizeof(pdfi_fontscan_cache));
+    cache->memory = ctx->memory;
+    cache->cur_size = -1;
+    ctx->fontscan_cache = cache;
+
+    cache->fname = (char *)gs_alloc_bytes(ctx->memory, fnamelen + 1, "pdfi_fontscan_cache_begin");
+    if (cache->fname == NULL)
+        return_error(gs_error_VMerror);
+    memcpy(cache->fname, fname, fnamelen);
+    cache->fname[fnamelen] = '\0';
+
+    in = gp_fopen(ctx->memory, cache->fname, "rb");
+    if (in != NULL) {
+        int64_t len;
+
+        if (gp_fseek(in, 0, SEEK_END) == 0 && (len = gp_ftell(in)) > 0 && len < max_int && gp_fseek(in, 0, SEEK_SET) == 0) {
+            cache->buf = gs_alloc_bytes(ctx->memory, len, "pdfi_fontscan_cache_begin");
+            if (cache->buf == NULL)
+                code = gs_note_error(gs_error_VMerror);
+            else if (gp_fread(cache->buf, 1, len, in) == len)
+                code = pdfi_fontscan_cache_parse(cache, len);
+        }
+        gp_fclose(in);
+    }
     return code;
 }
 
+/* Write the records we are keeping to a scratch file in the same directory as
+ * the cache, then rename it into place.
+ */
+static void pdfi_fontscan_cache_write(pdf_context *ctx, pdfi_fontscan_cache *cache)
+{
+    gs_memory_t *mem = ctx->memory;
+    pdfi_fontscan_record **all, *prev = NULL;
+    char tmpname[gp_file_name_sizeof];
+    char *prefix;
+    size_t fnamelen = strlen(cache->fname);
+    gp_file *out;
+    int i, n = 0, code = 0;
+
+    all = (pdfi_fontscan_record **)gs_alloc_bytes(mem, (cache->count + cache->num_found + 1) * sizeof(pdfi_fontscan_record *), "pdfi_fontscan_cache_write");
+    prefix = (char *)gs_alloc_bytes(mem, fnamelen + 2, "pdfi_fontscan_cache_write");
+    if (all == NULL || prefix == NULL)
+        goto exit;
+
+    for (i = 0; i < cache->count; i++)
+        if (cache->records[i].used)
+            all[n++] = &cache->records[i];
+    for (i = 0; i < cache->num_found; i++)
+        all[n++] = &cache->found[i];
+    qsort(all, n, sizeof(pdfi_fontscan_record *), pdfi_fontscan_compare_record_ptr);
+
+    memcpy(prefix, cache->fname, fnamelen);
+    memcpy(prefix + fnamelen, ".", 2);
+    out = gp_open_scratch_file(mem, prefix, tmpname, "wb");
+    if (out != NULL) {
+        /* Scratch files are only accessible to their owner. Re-create it under
+         * the same (unique) name, so that the cache gets the permissions any
+         * other file we write would have.
+         */
+        gp_fclose(out);
+        (void)gp_unlink(mem, tmpname);
+        out = gp_fopen(mem, tmpname, "wb");
+    }
+    if (out == NULL) {
+        errprintf(mem, "Could not create a file to write the font scan cache %s.\n", cache->fname);
+        goto exit;
+    }
+
+    for (i = 0; i < n; i++) {
+        pdfi_fontscan_record *r = all[i];
+
+        if (prev != NULL && pdfi_fontscan_compare_record(prev, r) == 0)
+            continue;
+        if (gp_fprintf(out, "%"PRId64" %"PRId64" %d %s\t%s\n", r->size, r->mtime, r->index, r->name, r->path) < 0)
+            code = gs_note_error(gs_error_ioerror);
+        prev = r;
+    }
+    if (gp_ferror(out))
+        code = gs_note_error(gs_error_ioerror);
+    if (gp_fclose(out) != 0)
+        code = gs_note_error(gs_error_ioerror);
+    if (code < 0 || gp_rename(mem, tmpname, cache->fname) != 0) {
+        errprintf(mem, "Could not write the font scan cache %s.\n", cache->fname);
+        (void)gp_unlink(mem, tmpname);
+    }
+
+ exit:
+    gs_free_object(mem, prefix, "pdfi_fontscan_cache_write");
+    gs_free_object(mem, all, "pdfi_fontscan_cache_write");
+}
+
+static void pdfi_fontscan_cache_end(pdf_context *ctx, bool write)
+{
+    pdfi_fontscan_cache *cache = ctx->fontscan_cache;
+    gs_memory_t *mem = ctx->memory;
+    int i;
+
+    if (cache == NULL)
+        return;
+
+    if (write && cache->fname != NULL)
+        pdfi_fontscan_cache_write(ctx, cache);
+
+    for (i = 0; i < cache->num_found; i++)
+        gs_free_object(mem, (char *)cache->found[i].name, "pdfi_fontscan_cache_end");
+    gs_free_object(mem, cache->found, "pdfi_fontscan_cache_end");
+    gs_free_object(mem, cache->fname, "pdfi_fontscan_cache_end");
+    gs_free_object(mem, cache->records, "pdfi_fontscan_cache_end");
+    gs_free_object(mem, cache->buf, "pdfi_fontscan_cache_end");
+    gs_free_object(mem, cache, "pdfi_fontscan_cache_end");
+    ctx->fontscan_cache = NULL;
+}
+
+/* Before scanning a font file, see if the cache already knows what is in it.
+ * Returns 1 if the fonts were added from the cache, 0 if the file needs scanning,
+ * in which case cur_size and cur_mtime are set for recording what the scan finds.
+ */
+static int pdfi_fontscan_cache_lookup(pdf_context *ctx, const char *fp)
+{
+    pdfi_fontscan_cache *cache = ctx->fontscan_cache;
+    struct stat st;
+    pdfi_fontscan_record *r, *first, *last;
+    int lo, hi, code = 0;
+
+    cache->cur_size = -1;
+    cache->cur_recorded = false;
+    if (gp_stat(ctx->memory, fp, &st) != 0)
+        return 0;
+
+    if (cache->count > 0) {
+        /* Find the first record for this file */
+        lo = 0;
+        hi = cache->count;
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+
+            if (strcmp(cache->records[mid].path, fp) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        first = &cache->records[lo];
+        last = cache->records + cache->count;
+        if (lo < cache->count && strcmp(first->path, fp) == 0 &&
+            first->size == (int64_t)st.st_size && first->mtime == (int64_t)st.st_mtime) {
+            for (r = first; r < last && strcmp(r->path, fp) == 0; r++) {
+                r->used = true;
+                if (r->index == FONTSCAN_NO_FONT)
+                    continue;
+                code = pdfi_add__to_native_fontmap(ctx, r->name, fp, r->index);
+                if (code < 0)
+                    return code;
+            }
+            return 1;
+        }
+    }
+
+    cache->cur_size = (int64_t)st.st_size;
+    cache->cur_mtime = (int64_t)st.st_mtime;
+    return 0;
+}
+
 static inline int
 pdfi_end_ps_token(int c)
 {
@@ -673,21 +1037,27 @@ static int pdfi_add_font_to_native_map(pdf_context *ctx, const char *fp, char *w
     if (font_scan_skip_file(fp))
         return 0;
 
+    if (ctx->fontscan_cache != NULL) {
+        code = pdfi_fontscan_cache_lookup(ctx, fp);
+        if (code != 0)
+            return code < 0 ? code : 0;
+    }
+
     sf = sfopen(fp, "r", ctx->memory);
     if (sf == NULL)
-        return 0;
+        goto exit;
     code = sgets(sf, magic, 4, &nread);
     if (code < 0 || nread < 4) {
         code = 0;
         sfclose(sf);
-        return 0;
+        goto exit;
     }
 
     code = sfseek(sf, 0, SEEK_SET);
     if (code < 0) {
         code = 0;
         sfclose(sf);
-        return 0;
+        goto exit;
     }
     /* Slightly naff: in this one case, we want to treat OTTO fonts
        as Truetype, so we lookup the TTF 'name' table - it's more efficient
@@ -716,6 +1086,13 @@ static int pdfi_add_font_to_native_map(pdf_context *ctx, const char *fp, char *w
     if (code != gs_error_VMerror)
         code = 0;
 
+    if (code == 0 && ctx->fontscan_cache != NULL && !ctx->fontscan_cache->cur_recorded)
+        pdfi_fontscan_cache_record(ctx->fontscan_cache, "", fp, FONTSCAN_NO_FONT);
+
+exit:
+    /* Anything added from here on is not the result of scanning this file */
+    if (ctx->fontscan_cache != NULL)
+        ctx->fontscan_cache->cur_size = -1;
     return code;
 }
 
@@ -786,6 +1163,13 @@ static int pdfi_generate_native_fontmap(pdf_context *ctx)
         return_error(gs_error_VMerror);
     }
 
+    if (ctx->args.nativefontmapcache.data != NULL) {
+        code = pdfi_fontscan_cache_begin(ctx);
+        if (code < 0)
+            pdfi_fontscan_cache_end(ctx, false);
+        code = 0;
+    }
+
     for (i = 0; i < ctx->search_paths.num_font_paths; i++) {
 
         memcpy(patrn, ctx->search_paths.font_paths[i].data, ctx->search_paths.font_paths[i].size);
@@ -808,6 +1192,7 @@ static int pdfi_generate_native_fontmap(pdf_context *ctx)
             gp_enumerate_files_close(ctx->memory, fe);
     }
     (void)pdfi_generate_platform_fontmap(ctx);
+    pdfi_fontscan_cache_end(ctx, code >= 0);
 
 #ifdef DUMP_NATIVE_FONTMAP
     if (ctx->pdfnativefontmap != NULL) {
@@ -25,6 +25,7 @@
 #include "pdf_file.h"
 #include "pdf_dict.h"
 #include "pdf_array.h"
+#include "pdf_obj.h"
 #include "pdf_loop_detect.h"
 #include "pdf_colour.h"
 #include "pdf_trans.h"
@@ -32,6 +33,10 @@
 #include "pdf_optcontent.h"
 #include "pdf_mark.h"
 #include "stream.h"     /* for stell() */
+#include "sdct.h"       /* for s_DCTD_set_scale() */
+#if defined(USE_OPENJPEG_JP2)
+#  include "sjpx_openjpeg.h"    /* for s_jpxd_set_scale() */
+#endif
 #include "gsicc_cache.h"
 
 #include "gspath2.h"
@@ -1643,6 +1648,255 @@ pdfi_make_smask_dict(pdf_context *ctx, pdf_stream *image_stream, pdfi_image_info
     return code;
 }
 
+/* Decoded image data cache.
+ * Images used on many pages (logos, letterheads, full page backgrounds) would
+ * otherwise run through the whole filter chain every time they are drawn.
+ * When -dImageCacheSize is non-zero we keep the decoded sample data of image
+ * XObjects, keyed by object and generation number, stream offset and decoding
+ * parameters, in an LRU list holding at most that many bytes. The data is held
+ * before any ImScale filter, so the cache does not depend on the CTM.
+ */
+static void
+pdfi_image_cache_unlink(pdf_context *ctx, pdfi_image_cache_entry *entry)
+{
+    if (entry->previous)
+        ((pdfi_image_cache_entry *)entry->previous)->next = entry->next;
+    else
+        ctx->image_cache_LRU = entry->next;
+    if (entry->next)
+        ((pdfi_image_cache_entry *)entry->next)->previous = entry->previous;
+    else
+        ctx->image_cache_MRU = entry->previous;
+    entry->next = entry->previous = NULL;
+}
+
+static void
+pdfi_image_cache_link_MRU(pdf_context *ctx, pdfi_image_cache_entry *entry)
+{
+    entry->previous = ctx->image_cache_MRU;
+    entry->next = NULL;
+    if (ctx->image_cache_MRU)
+        ctx->image_cache_MRU->next = entry;
+    ctx->image_cache_MRU = entry;
+    if (ctx->image_cache_LRU == NULL)
+        ctx->image_cache_LRU = entry;
+}
+
+static void
+pdfi_image_cache_free_entry(pdf_context *ctx, pdfi_image_cache_entry *entry)
+{
+    pdfi_image_cache_unlink(ctx, entry);
+    ctx->image_cache_used -= entry->size;
+    gs_free_object(ctx->memory, entry->params, "pdfi_image_cache_free_entry (params)");
+    gs_free_object(ctx->memory, entry->data, "pdfi_image_cache_free_entry (data)");
+    gs_free_object(ctx->memory, entry, "pdfi_image_cache_free_entry");
+}
+
+void
+pdfi_purge_image_cache(pdf_context *ctx)
+{
+    while (ctx->image_cache_LRU != NULL)
+        pdfi_image_cache_free_entry(ctx, ctx->image_cache_LRU);
+}
+
+/* Describe everything other than the stream data that the decoded samples
+ * depend on, or are interpreted with: the dimensions, the filters and their
+ * DecodeParms, the Decode array, and the ImageMask and Mask (stencil or colour
+ * key) state. An entry is only used for an image with an identical description.
+ */
+static int
+pdfi_image_cache_params(pdf_context *ctx, pdfi_image_info_t *info, int comps,
+                        byte **params, int *params_len)
+{
+    char header[128];
+    int header_len, len = 0, code;
+    pdf_array *desc = NULL;
+    byte *data = NULL;
+
+    *params = NULL;
+    *params_len = 0;
+
+    code = pdfi_array_alloc(ctx, 4, &desc);
+    if (code < 0)
+        return code;
+    pdfi_countup(desc);
+    if (info->Filter != NULL)
+        code = pdfi_array_put(ctx, desc, 0, info->Filter);
+    if (code >= 0 && info->DecodeParms != NULL)
+        code = pdfi_array_put(ctx, desc, 1, info->DecodeParms);
+    if (code >= 0 && info->Decode != NULL)
+        code = pdfi_array_put(ctx, desc, 2, info->Decode);
+    if (code >= 0 && info->Mask != NULL)
+        code = pdfi_array_put(ctx, desc, 3, info->Mask);
+    if (code >= 0)
+        code = pdfi_obj_to_string(ctx, (pdf_obj *)desc, &data, &len);
+    pdfi_countdown(desc);
+    if (code < 0)
+        return code;
+
+    header_len = gs_snprintf(header, sizeof(header), "%"PRIi64" %"PRIi64" %"PRIi64" %d %d %"PRIi64" ",
+                             info->Width, info->Height, info->BPC, comps,
+                             info->ImageMask, info->SMaskInData);
+    *params = gs_alloc_bytes(ctx->memory, header_len + len, "pdfi_image_cache_params");
+    if (*params == NULL) {
+        gs_free_object(ctx->memory, data, "pdfi_image_cache_params");
+        return_error(gs_error_VMerror);
+    }
+    memcpy(*params, header, header_len);
+    memcpy(*params + header_len, data, len);
+    *params_len = header_len + len;
+    gs_free_object(ctx->memory, data, "pdfi_image_cache_params");
+    return 0;
+}
+
+/* Find an image in the cache. The entry returned is marked as in use, so that
+ * drawing another image while this one is being drawn (a pattern or an SMask
+ * containing an image, for example) cannot evict it and free the data. The
+ * caller must call pdfi_image_cache_release() when it has finished with it.
+ */
+static pdfi_image_cache_entry *
+pdfi_image_cache_find(pdf_context *ctx, pdf_stream *image_stream, gs_offset_t stream_offset,
+                      const byte *params, int params_len)
+{
+    pdfi_image_cache_entry *entry;
+
+    for (entry = ctx->image_cache_MRU; entry != NULL; entry = entry->previous) {
+        if (entry->object_num == image_stream->object_num &&
+            entry->generation_num == image_stream->generation_num &&
+            entry->stream_offset == stream_offset &&
+            entry->params_len == params_len &&
+            memcmp(entry->params, params, params_len) == 0) {
+            if (entry != ctx->image_cache_MRU) {
+                pdfi_image_cache_unlink(ctx, entry);
+                pdfi_image_cache_link_MRU(ctx, entry);
+            }
+            entry->in_use++;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void
+pdfi_image_cache_release(pdf_context *ctx, pdfi_image_cache_entry *entry)
+{
+    if (entry != NULL)
+        entry->in_use--;
+}
+
+/* Add decoded data to the cache. On success the cache owns 'data' and '*params'
+ * (which is set to NULL), and the new entry is returned in *pentry marked as
+ * in use, as for pdfi_image_cache_find().
+ * Entries which are in use are never evicted, if the space can't be found
+ * without evicting them the data isn't cached.
+ */
+static int
+pdfi_image_cache_add(pdf_context *ctx, pdf_stream *image_stream, gs_offset_t stream_offset,
+                     byte **params, int params_len,
+                     byte *data, uint64_t size, pdfi_image_cache_entry **pentry)
+{
+    pdfi_image_cache_entry *entry, *next;
+
+    if (size > (uint64_t)ctx->args.image_cache_size)
+        return 0;
+    entry = ctx->image_cache_LRU;
+    while (entry != NULL &&
+           ctx->image_cache_used + size > (uint64_t)ctx->args.image_cache_size) {
+        next = entry->next;
+        if (entry->in_use == 0)
+            pdfi_image_cache_free_entry(ctx, entry);
+        entry = next;
+    }
+    if (ctx->image_cache_used + size > (uint64_t)ctx->args.image_cache_size)
+        return 0;
+
+    entry = (pdfi_image_cache_entry *)gs_alloc_bytes(ctx->memory, sizeof(pdfi_image_cache_entry), "pdfi_image_cache_add");
+    if (entry == NULL)
+        return 0;
+    memset(entry, 0x00, sizeof(pdfi_image_cache_entry));
+    entry->object_num = image_stream->object_num;
+    entry->generation_num = image_stream->generation_num;
+    entry->stream_offset = stream_offset;
+    entry->params = *params;
+    entry->params_len = params_len;
+    *params = NULL;
+    entry->size = size;
+    entry->data = data;
+    entry->in_use = 1;
+    pdfi_image_cache_link_MRU(ctx, entry);
+    ctx->image_cache_used += size;
+    *pentry = entry;
+    return 1;
+}
+
+/* Read all the decoded data the image will consume from 'image_stream' into
+ * a buffer, replace the stream with a memory stream reading that buffer, and
+ * offer the buffer to the cache. If the cache takes it the new entry is returned
+ * in *entry (in use, see above), otherwise *buffer is returned so that the
+ * caller can free it once the image is drawn.
+ */
+static int
+pdfi_image_cache_fill(pdf_context *ctx, pdf_stream *image_stream, gs_offset_t stream_offset,
+                      byte **params, int params_len,
+                      uint64_t data_size, pdf_c_stream **image_data, byte **buffer,
+                      pdfi_image_cache_entry **entry)
+{
+    byte *data;
+    uint count = 0;
+    int status, code;
+
+    data = gs_alloc_bytes(ctx->memory, data_size, "pdfi_image_cache_fill");
+    if (data == NULL)
+        return 0; /* Not an error, just draw the image from the stream */
+
+    status = sgets((*image_data)->s, data, data_size, &count);
+    pdfi_close_file(ctx, *image_data);
+    *image_data = NULL;
+
+    code = pdfi_open_memory_stream_from_memory(ctx, count, data, image_data, true);
+    if (code < 0) {
+        gs_free_object(ctx->memory, data, "pdfi_image_cache_fill");
+        return code;
+    }
+    /* Don't keep the data if the filters reported an error, the image
+     * will be drawn (as far as it goes) but not cached.
+     */
+    if (status == ERRC ||
+        !pdfi_image_cache_add(ctx, image_stream, stream_offset, params, params_len, data, count, entry))
+        *buffer = data;
+    return 0;
+}
+
+/* If the image is drawn at no more than half size in both directions, ask
+ * the DCTDecode or JPXDecode filter supplying its data (if that is what it
+ * is) to decode at 1/2 or 1/4 size, adjusting the image dimensions and
+ * ImageMatrix to match. We stop at 1/4 because the IJG 1x1 IDCT (1/8 size)
+ * in our copy of the library does not produce correct samples.
+ */
+static int
+pdfi_image_apply_scale(pdf_context *ctx, gs_pixel_image_t *pim, pdfi_image_info_t *info,
+                       pdf_c_stream *image_stream)
+{
+    int denom, code;
+
+    denom = gs_image_reduction_denom(ctx->pgs, pim, 4);
+    if (denom == 1)
+        return 0;
+    if (!s_DCTD_set_scale(image_stream->s, denom)
+#if defined(USE_OPENJPEG_JP2)
+        && !s_jpxd_set_scale(image_stream->s, denom)
+#endif
+        )
+        return 0;
+
+    code = gs_pixel_image_reduce(pim, denom);
+    if (code < 0)
+        return code;
+    info->Width = pim->Width;
+    info->Height = pim->Height;
+    return 0;
+}
+
 /* NOTE: "source" is the current input stream.
  * on exit:
  *  inline_image = TRUE, stream it will point to after the image data.
@@ -1679,6 +1933,12 @@ pdfi_do_image(pdf_context *ctx, pdf_dict *page_dict, pdf_dict *stream_dict, pdf_
     gs_offset_t stream_offset;
     float save_strokeconstantalpha = 0.0f, save_fillconstantalpha = 0.0f;
     int trans_required;
+    bool use_image_cache;
+    uint64_t data_size;
+    pdfi_image_cache_entry *cache_entry = NULL;
+    byte *cache_params = NULL;
+    int cache_params_len = 0;
+    byte *image_buffer = NULL;
 
 #if DEBUG_IMAGES
     dbgmprintf(ctx->memory, "pdfi_do_image BEGIN\n");
@@ -2045,19 +2305,51 @@ pdfi_do_image(pdf_context *ctx, pdf_dict *page_dict, pdf_dict *stream_dict, pdf_
         if (code < 0)
             goto cleanupExit;
     }
-    /* Setup the data stream for the image data */
-    if (!inline_image) {
-        pdfi_seek(ctx, source, stream_offset, SEEK_SET);
-
-        code = pdfi_apply_SubFileDecode_filter(ctx, 0, "endstream", source, &SFD_stream, false);
+    /* Use the decoded data cache for XObject images, but not with high level
+     * devices: those may be passed the compressed data by the DCT and JPX
+     * filters, so the filters must run for every use of the image.
+     */
+    data_size = pdfi_get_image_data_size((gs_data_image_t *)pim, comps);
+    use_image_cache = !inline_image && ctx->args.image_cache_size > 0 &&
+        image_stream->object_num != 0 && !ctx->device_state.HighLevelDevice &&
+        data_size <= (uint64_t)ctx->args.image_cache_size;
+    if (use_image_cache) {
+        code = pdfi_image_cache_params(ctx, &image_info, comps, &cache_params, &cache_params_len);
         if (code < 0)
             goto cleanupExit;
-        source = SFD_stream;
+        cache_entry = pdfi_image_cache_find(ctx, image_stream, stream_offset,
+                                            cache_params, cache_params_len);
+        if (cache_entry != NULL) {
+            code = pdfi_open_memory_stream_from_memory(ctx, cache_entry->size, cache_entry->data,
+                                                       &new_stream, true);
+            if (code < 0)
+                goto cleanupExit;
+        }
     }
 
-    code = pdfi_filter(ctx, image_stream, source, &new_stream, inline_image);
-    if (code < 0)
-        goto cleanupExit;
+    if (cache_entry == NULL) {
+        /* Setup the data stream for the image data */
+        if (!inline_image) {
+            pdfi_seek(ctx, source, stream_offset, SEEK_SET);
+
+            code = pdfi_apply_SubFileDecode_filter(ctx, 0, "endstream", source, &SFD_stream, false);
+            if (code < 0)
+                goto cleanupExit;
+            source = SFD_stream;
+        }
+
+        code = pdfi_filter(ctx, image_stream, source, &new_stream, inline_image);
+        if (code < 0)
+            goto cleanupExit;
+
+        if (use_image_cache) {
+            code = pdfi_image_cache_fill(ctx, image_stream, stream_offset,
+                                         &cache_params, cache_params_len, data_size,
+                                         &new_stream, &image_buffer, &cache_entry);
+            if (code < 0)
+                goto cleanupExit;
+        }
+    }
 
     /* This duplicates the code in gs_img.ps; if we have an imagemask, with 1 bit per component (is there any other kind ?)
      * and the image is to be interpolated, and we are nto sending it to a high level device. Then check the scaling.
@@ -2124,6 +2416,24 @@ pdfi_do_image(pdf_context *ctx, pdf_dict *page_dict, pdf_dict *stream_dict, pdf_
         }
     }
 
+    /* If a JPEG or JPEG 2000 image is going to be drawn at half its size or
+     * less, have the filter decode it at reduced size (in the IDCT, or by
+     * discarding wavelet resolution levels), and draw the smaller image.
+     * Images with masks must keep their full size, so that the samples of the
+     * image and the mask still correspond, and the samples of an Indexed
+     * image can't be averaged.
+     */
+    if (!use_image_cache && !ctx->args.nodctscaling &&
+        !ctx->device_state.HighLevelDevice && !image_info.ImageMask &&
+        image_info.Mask == NULL && image_info.SMask == NULL &&
+        image_info.SMaskInData == 0 && image_info.BPC == 8 &&
+        (pcs == NULL || pcs->type->index != gs_color_space_index_Indexed))
+    {
+        code = pdfi_image_apply_scale(ctx, pim, &image_info, new_stream);
+        if (code < 0)
+            goto cleanupExit;
+    }
+
     trans_required = pdfi_trans_required(ctx);
 
     if (trans_required) {
@@ -2173,6 +2483,11 @@ pdfi_do_image(pdf_context *ctx, pdf_dict *page_dict, pdf_dict *stream_dict, pdf_
         pdfi_close_file(ctx, SFD_stream);
     if (mask_buffer)
         gs_free_object(ctx->memory, mask_buffer, "pdfi_do_image (mask_buffer)");
+    if (image_buffer)
+        gs_free_object(ctx->memory, image_buffer, "pdfi_do_image (image_buffer)");
+    pdfi_image_cache_release(ctx, cache_entry);
+    if (cache_params)
+        gs_free_object(ctx->memory, cache_params, "pdfi_do_image (cache_params)");
 
     pdfi_countdown(alt_stream);
 
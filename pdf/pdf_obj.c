@@ -82,7 +82,10 @@ int pdfi_object_alloc(pdf_context *ctx, pdf_obj_type type, unsigned int size, pd
             code = gs_note_error(gs_error_typecheck);
             goto error_out;
     }
-    *obj = (pdf_obj *)gs_alloc_bytes(ctx->memory, bytes, "pdfi_object_alloc");
+    if ((type == PDF_INT || type == PDF_REAL) && ctx->num_free_count > 0)
+        *obj = ctx->num_free_list[--ctx->num_free_count];
+    else
+        *obj = (pdf_obj *)gs_alloc_bytes(ctx->memory, bytes, "pdfi_object_alloc");
     if (*obj == NULL) {
         code = gs_note_error(gs_error_VMerror);
         goto error_out;
@@ -262,11 +265,17 @@ void pdfi_free_object(pdf_obj *o)
     if ((intptr_t)o < (intptr_t)TOKEN__LAST_KEY)
         return;
     switch(o->type) {
+        case PDF_INT:
+        case PDF_REAL:
+            /* Keep a few numbers back for pdfi_object_alloc() to reuse */
+            if (OBJ_CTX(o)->num_free_count < MAX_NUM_FREE_LIST_SIZE) {
+                OBJ_CTX(o)->num_free_list[OBJ_CTX(o)->num_free_count++] = o;
+                break;
+            }
+            /* Fall through */
         case PDF_ARRAY_MARK:
         case PDF_DICT_MARK:
         case PDF_PROC_MARK:
-        case PDF_INT:
-        case PDF_REAL:
         case PDF_INDIRECT:
             gs_free_object(OBJ_MEMORY(o), o, "pdf interpreter object refcount to 0");
             break;
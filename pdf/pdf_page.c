@@ -770,9 +770,13 @@ page_error:
     if (code < 0)
         goto exit;
 
-    code = pdfi_get_page_dict(ctx, ctx->PagesTree, page_num, &page_offset, dict, NULL);
-    if (code > 0)
-        code = gs_error_unknownerror;
+    code = pdfi_doc_page_index_get(ctx, page_num, dict);
+    if (code > 0) {
+        /* Not in the page index, walk the Pages tree to find it */
+        code = pdfi_get_page_dict(ctx, ctx->PagesTree, page_num, &page_offset, dict, NULL);
+        if (code > 0)
+            code = gs_error_unknownerror;
+    }
 
     /* Cache the page_dict number in page_array */
     if (*dict)
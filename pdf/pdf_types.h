@@ -217,6 +217,8 @@ typedef struct pdf_dict_s {
     pdf_dict_entry *list;
     bool dict_written;  /* Has dict been written (for pdfwrite) */
     bool is_sorted;     /* true if the dictionary has been sorted by Key, for faster searching */
+    uint32_t *hash;     /* Hash index of large dictionaries (list index + 1, 0 is empty), or NULL */
+    uint32_t hash_size; /* Number of slots in hash, a power of 2 */
 } pdf_dict;
 
 typedef struct pdf_stream_s {
@@ -252,6 +254,20 @@ typedef struct pdf_obj_cache_entry_s {
     pdf_obj *o;
 }pdf_obj_cache_entry;
 
+/* An entry in the cache of decoded image data, see pdf_image.c */
+typedef struct pdfi_image_cache_entry_s {
+    void *next;
+    void *previous;
+    uint32_t object_num;
+    uint32_t generation_num;
+    gs_offset_t stream_offset;
+    byte *params;       /* Decoding parameters, see pdfi_image_cache_params() */
+    int params_len;
+    uint64_t size;
+    byte *data;
+    int in_use;         /* Images currently reading 'data', the entry can't be evicted */
+}pdfi_image_cache_entry;
+
 /* The compressed and uncompressed xref entries are identical, they only differ
  * in the names used for the variables. Its simply less confusing not to overload
  * the names.
@@ -642,6 +642,16 @@ pdf_impl_set_param(pl_interp_implementation_t *impl,
             if (code < 0)
                 return code;
         }
+        if (argis(param, "ImageCacheSize")) {
+            code = plist_value_get_int(&pvalue, &ctx->args.image_cache_size);
+            if (code < 0)
+                return code;
+        }
+        if (argis(param, "NoDCTScaling")) {
+            code = plist_value_get_bool(&pvalue, &ctx->args.nodctscaling);
+            if (code < 0)
+                return code;
+        }
         if (argis(param, "NoUserUnit")) {
             code = plist_value_get_bool(&pvalue, &ctx->args.nouserunit);
             if (code < 0)
@@ -731,6 +741,11 @@ pdf_impl_set_param(pl_interp_implementation_t *impl,
             if (code < 0)
                 return code;
         }
+        if (argis(param, "NativeFontMapCache")) {
+            code = plist_value_get_string_or_name(ctx, &pvalue, (char **)&ctx->args.nativefontmapcache.data, (int *)&ctx->args.nativefontmapcache.size, &discard_isname);
+            if (code < 0)
+                return code;
+        }
         if (argis(param, "OutputFile")) {
             if (!Printed_set)
                 ctx->args.printed = true;
@@ -134,6 +134,7 @@ context_state_alloc(gs_context_state_t ** ppcst,
     pcst->dict_stack.system_dict = *psystem_dict;
     pcst->dict_stack.min_size = 0;
     pcst->dict_stack.userdict_index = 0;
+    dstack_clear_lookup_cache(&pcst->dict_stack);
     pcst->pgs = int_gstate_alloc(dmem);
     if (pcst->pgs == 0) {
         code = gs_note_error(gs_error_VMerror);
@@ -34,4 +34,10 @@ void dstack_set_top(dict_stack_t *);
 /* Check whether a dictionary is one of the permanent ones on the d-stack. */
 bool dstack_dict_is_permanent(const dict_stack_t *, const ref *);
 
+/*
+ * Invalidate the name lookup cache if a dictionary is on the stack.
+ * Every routine that adds or removes a key must call this.
+ */
+void dstack_note_dict_keys_changed(dict_stack_t *, const ref *);
+
 #endif /* iddstack_INCLUDED */
@@ -512,6 +512,8 @@ dict_put(ref * pdref /* t_dictionary */ , const ref * pkey, const ref * pvalue,
         }
         ref_save_in(mem, pdref, &pdict->count, "dict_put(count)");
         pdict->count.value.intval++;
+        if (pds)
+            dstack_note_dict_keys_changed(pds, pdref);
         /* If the key is a name, update its 1-element cache. */
         if (r_has_type(pkey, t_name)) {
             name *pname = pkey->value.pname;
@@ -653,6 +655,8 @@ dict_undef(ref * pdref, const ref * pkey, dict_stack_t *pds)
     }
     ref_save_in(mem, pdref, &pdict->count, "dict_undef(count)");
     pdict->count.value.intval--;
+    if (pds)
+        dstack_note_dict_keys_changed(pds, pdref);
     /* If the key is a name, update its 1-element cache. */
     if (r_has_type(pkey, t_name)) {
         name *pname = pkey->value.pname;
@@ -22,6 +22,9 @@
 #include "isdata.h"
 #include "iddstack.h"
 
+/* Define the size of the name lookup cache; must be a power of 2. */
+#define DSTACK_LOOKUP_CACHE_SIZE 256
+
 /* Define the dictionary stack structure. */
 struct dict_stack_s {
 
@@ -66,6 +69,22 @@ struct dict_stack_s {
  */
     ref system_dict;
 
+/*
+ * Cache the results of recent full-stack name lookups, indexed by the
+ * low bits of the name index.  An entry is only valid if its generation
+ * matches lookup_generation, which is advanced whenever the stack
+ * changes, a key is added to or removed from a dictionary on the stack,
+ * or value slots may have moved (resize, restore, garbage collection).
+ * The value pointers are not traced by the GC for the same reason as
+ * top_values.
+ */
+    uint lookup_generation;
+    struct {
+        uint nidx;
+        uint generation;
+        ref *pvalue;
+    } lookup_cache[DSTACK_LOOKUP_CACHE_SIZE];
+
 };
 
 /*
@@ -15,6 +15,7 @@
 
 
 /* Implementation of dictionary stacks */
+#include "memory_.h"
 #include "ghost.h"
 #include "idict.h"
 #include "idictdef.h"
@@ -99,12 +100,43 @@ dstack_dict_is_permanent(const dict_stack_t * pds, const ref * pdref)
     return false;
 }
 
+/* Empty the name lookup cache. */
+void
+dstack_clear_lookup_cache(dict_stack_t * pds)
+{
+    memset(pds->lookup_cache, 0, sizeof(pds->lookup_cache));
+    pds->lookup_generation = 1;
+}
+
+/* Invalidate the name lookup cache. */
+static void
+dstack_invalidate_lookups(dict_stack_t * pds)
+{
+    if (++(pds->lookup_generation) == 0)
+        dstack_clear_lookup_cache(pds);
+}
+
+/* Invalidate the name lookup cache if a dictionary is on the d-stack. */
+void
+dstack_note_dict_keys_changed(dict_stack_t * pds, const ref * pdref)
+{
+    dict *pdict = pdref->value.pdict;
+    uint count = ref_stack_count(&pds->stack);
+    uint i;
+
+    for (i = 0; i < count; ++i)
+        if (ref_stack_index(&pds->stack, i)->value.pdict == pdict) {
+            dstack_invalidate_lookups(pds);
+            return;
+        }
+}
+
 /*
- * Look up a name on the dictionary stack.
+ * Search the dictionary stack for a name, bypassing the lookup cache.
  * Return the pointer to the value if found, 0 if not.
  */
-ref *
-dstack_find_name_by_index(dict_stack_t * pds, uint nidx)
+static ref *
+dstack_search_name_by_index(dict_stack_t * pds, uint nidx)
 {
     ds_ptr pdref = pds->stack.p;
 
@@ -201,6 +233,28 @@ dstack_find_name_by_index(dict_stack_t * pds, uint nidx)
 #undef hash
 }
 
+/*
+ * Look up a name on the dictionary stack.
+ * Return the pointer to the value if found, 0 if not.
+ */
+ref *
+dstack_find_name_by_index(dict_stack_t * pds, uint nidx)
+{
+    uint ci = nidx & (DSTACK_LOOKUP_CACHE_SIZE - 1);
+    ref *pvalue;
+
+    if (pds->lookup_cache[ci].nidx == nidx &&
+        pds->lookup_cache[ci].generation == pds->lookup_generation)
+        return pds->lookup_cache[ci].pvalue;
+    pvalue = dstack_search_name_by_index(pds, nidx);
+    if (pvalue != 0) {
+        pds->lookup_cache[ci].nidx = nidx;
+        pds->lookup_cache[ci].generation = pds->lookup_generation;
+        pds->lookup_cache[ci].pvalue = pvalue;
+    }
+    return pvalue;
+}
+
 /* Set the cached values computed from the top entry on the dstack. */
 /* See idstack.h for details. */
 static const ref_packed no_packed_keys[2] =
@@ -213,6 +267,7 @@ dstack_set_top(dict_stack_t * pds)
 
     if_debug3('d', "[d]dsp = "PRI_INTPTR" -> "PRI_INTPTR", key array type = %d\n",
               (intptr_t)dsp, (intptr_t)pdict, r_type(&pdict->keys));
+    dstack_invalidate_lookups(pds);
     if (dict_is_packed(pdict) &&
         r_has_attr(dict_access_ref(dsp), a_read)
         ) {
@@ -237,6 +292,7 @@ dstack_gc_cleanup(dict_stack_t * pds)
     uint count = ref_stack_count(&pds->stack);
     uint dsi;
 
+    dstack_invalidate_lookups(pds);
     for (dsi = pds->min_size; dsi > 0; --dsi) {
         const dict *pdict =
         ref_stack_index(&pds->stack, count - dsi)->value.pdict;
@@ -30,6 +30,9 @@ typedef const_s_ptr const_ds_ptr;
 /* Clean up a dictionary stack after a garbage collection. */
 void dstack_gc_cleanup(dict_stack_t *);
 
+/* Empty the name lookup cache, e.g. when initializing the stack. */
+void dstack_clear_lookup_cache(dict_stack_t *);
+
 /*
  * Define a special fast entry for name lookup on a dictionary stack.
  * The key is known to be a name; search the entire dict stack.
@@ -189,7 +189,7 @@ $(PSOBJ)idparam.$(OBJ) : $(PSSRC)idparam.c $(GH) $(memory__h) $(string__h) $(ier
  $(oper_h) $(store_h) $(INT_MAK) $(MAKEDIRS)
 	$(PSCC) $(PSO_)idparam.$(OBJ) $(C_) $(PSSRC)idparam.c
 
-$(PSOBJ)idstack.$(OBJ) : $(PSSRC)idstack.c $(GH)\
+$(PSOBJ)idstack.$(OBJ) : $(PSSRC)idstack.c $(GH) $(memory__h)\
  $(idebug_h) $(idict_h) $(idictdef_h) $(idicttpl_h) $(idstack_h) $(iname_h) $(inamedef_h)\
  $(ipacked_h) $(iutil_h) $(ivmspace_h) $(INT_MAK) $(MAKEDIRS)
 	$(PSCC) $(PSO_)idstack.$(OBJ) $(C_) $(PSSRC)idstack.c
@@ -515,8 +515,8 @@ $(PSOBJ)zimage.$(OBJ) : $(PSSRC)zimage.c $(OP) $(math__h) $(memory__h) $(stat__h
  $(gscspace_h) $(gscssub_h) $(gsimage_h) $(gsmatrix_h) $(gsstruct_h)\
  $(gxiparam_h)\
  $(estack_h) $(ialloc_h) $(ifilter_h) $(igstate_h) $(iimage_h) $(ilevel_h)\
- $(store_h) $(stream_h) $(gxcspace_h)\
- $(INT_MAK) $(MAKEDIRS)
+ $(store_h) $(stream_h) $(gxcspace_h) $(gxdevsop_h) $(dstack_h)\
+ $(jpeglib__h) $(sdct_h) $(INT_MAK) $(MAKEDIRS)
 	$(PSCC) $(PSO_)zimage.$(OBJ) $(C_) $(PSSRC)zimage.c
 
 $(PSOBJ)zmatrix.$(OBJ) : $(PSSRC)zmatrix.c $(OP)\
@@ -1236,7 +1236,7 @@ $(PSD)jpx_.dev : $(ECHOGS_XE) $(INT_MAK) $(MAKEDIRS)
 $(PSOBJ)zfjpx.$(OBJ) : $(PSSRC)zfjpx.c $(OP) $(memory__h)\
  $(gsstruct_h) $(gstypes_h) $(ialloc_h) $(idict_h) $(ifilter_h)\
  $(store_h) $(stream_h) $(strimpl_h) $(ialloc_h) $(iname_h)\
- $(gdebug_h) $(sjpx_h) $(INT_MAK) $(MAKEDIRS)
+ $(gdebug_h) $(gxdevsop_h) $(sjpx_h) $(INT_MAK) $(MAKEDIRS)
 	$(PSJASCC) $(PSO_)zfjpx.$(OBJ) $(C_) $(PSSRC)zfjpx.c
 
 fjpx_openjpeg=$(PSOBJ)zfjpx_openjpeg.$(OBJ)
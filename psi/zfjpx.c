@@ -62,6 +62,30 @@ static int PS_JPXD_PassThrough(void *d, byte *Buffer, int Size)
     return 0;
 }
 
+/* The number of threads the device renders with, 0 if it has none */
+static int
+jpx_num_threads(gx_device *dev)
+{
+    char data[] = "NumRenderingThreads";
+    dev_param_req_t request;
+    gs_c_param_list list;
+    int nthreads = 0;
+    int code;
+
+    gs_c_param_list_write(&list, dev->memory);
+    request.Param = data;
+    request.list = &list;
+    code = dev_proc(dev, dev_spec_op)(dev, gxdso_get_dev_param, &request, sizeof(dev_param_req_t));
+    if (code < 0) {
+        gs_c_param_list_release(&list);
+        return 0;
+    }
+    gs_c_param_list_read(&list);
+    code = param_read_int((gs_param_list *)&list, "NumRenderingThreads", &nthreads);
+    gs_c_param_list_release(&list);
+    return code == 0 ? nthreads : 0;
+}
+
 /* <source> /JPXDecode <file> */
 /* <source> <dict> /JPXDecode <file> */
 static int
@@ -168,6 +192,8 @@ z_jpx_decode(i_ctx_t * i_ctx_p)
         state.PassThrough = 0;
         state.device = (void *)NULL;
     }
+    /* Decode with as many threads as the device renders with */
+    state.NumThreads = jpx_num_threads(dev);
 
     /* we pass npop=0, since we've no arguments left to consume */
     /* we pass 0 instead of the usual rspace(sop) which will allocate storage
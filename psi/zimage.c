@@ -39,6 +39,9 @@
 #include "ifilter.h"		/* for stream exception handling */
 #include "iimage.h"
 #include "gxcspace.h"
+#include "gxdevsop.h"
+#include "dstack.h"		/* for systemdict */
+#include "sdct.h"		/* for s_DCTD_set_scale */
 
 /* Forward references */
 static int zimage_data_setup(i_ctx_t *i_ctx_p, const gs_pixel_image_t * pim,
@@ -187,6 +190,68 @@ zimage_setup(i_ctx_t *i_ctx_p, const gs_pixel_image_t * pim,
                              sources, npop);
 }
 
+/* Test whether the current device is a high-level (vector) device. */
+static bool
+zimage_high_level_device(gx_device *dev)
+{
+    char data[] = "HighLevelDevice";
+    dev_param_req_t request;
+    gs_c_param_list list;
+    bool highlevel = false;
+    int code;
+
+    gs_c_param_list_write(&list, dev->memory);
+    request.Param = data;
+    request.list = &list;
+    code = dev_proc(dev, dev_spec_op)(dev, gxdso_get_dev_param, &request, sizeof(dev_param_req_t));
+    if (code < 0) {
+        gs_c_param_list_release(&list);
+        return false;
+    }
+    gs_c_param_list_read(&list);
+    code = param_read_bool((gs_param_list *)&list, "HighLevelDevice", &highlevel);
+    gs_c_param_list_release(&list);
+    return code == 0 && highlevel;
+}
+
+/*
+ * If the samples of an image come from a DCTDecode filter which has not
+ * read any data yet, and the image is drawn at no more than half size,
+ * have the filter decode at 1/2 or 1/4 size and adjust the image to match.
+ * As in the PDF interpreter, this is not done for high-level devices,
+ * Indexed images or when -dNoDCTScaling is set.
+ * Returns the stream that will scale, or NULL.
+ */
+static stream *
+zimage_DCT_scale(i_ctx_t *i_ctx_p, gs_pixel_image_t *pim, const image_params *pip)
+{
+    const ref *pds = &pip->DataSource[0];
+    ref *pnds;
+    stream *s;
+    int denom;
+
+    if (pip->MultipleDataSources || !r_has_type(pds, t_file) ||
+        pim->BitsPerComponent != 8 || pim->ColorSpace == NULL ||
+        gs_color_space_get_index(pim->ColorSpace) == gs_color_space_index_Indexed)
+        return NULL;
+    s = fptr(pds);
+    if (s->read_id != r_size(pds) || s->procs.process != s_DCTD_template.process)
+        return NULL;
+    if (dict_find_string(systemdict, "NoDCTScaling", &pnds) > 0 &&
+        r_has_type(pnds, t_boolean) && pnds->value.boolval)
+        return NULL;
+    denom = gs_image_reduction_denom(igs, pim, 4);
+    if (denom == 1 || zimage_high_level_device(gs_currentdevice(igs)))
+        return NULL;
+    if (!s_DCTD_set_scale(s, denom))
+        return NULL;
+    if (gs_pixel_image_reduce(pim, denom) < 0) {
+        s_DCTD_set_scale(s, 1);
+        return NULL;
+    }
+    return s;
+}
+
 /* <dict> .image1 - */
 static int
 zimage1(i_ctx_t *i_ctx_p)
@@ -196,6 +261,7 @@ zimage1(i_ctx_t *i_ctx_p)
     image_params    ip;
     int             code;
     gs_color_space *csp = gs_currentcolorspace(igs);
+    stream         *s;
 
     check_op(1);
     /* Adobe interpreters accept sampled images when the current color
@@ -241,11 +307,15 @@ zimage1(i_ctx_t *i_ctx_p)
         image.ImageMatrix.tx = image.ImageMatrix.ty;
         image.ImageMatrix.ty = ftmp;
     }
-    return zimage_setup( i_ctx_p,
+    s = zimage_DCT_scale(i_ctx_p, (gs_pixel_image_t *)&image, &ip);
+    code = zimage_setup( i_ctx_p,
                          (gs_pixel_image_t *)&image,
                          &ip.DataSource[0],
                          image.CombineWithColor,
                          1 );
+    if (code < 0 && s != NULL)
+        s_DCTD_set_scale(s, 1);
+    return code;
 }
 
 /* <dict> .imagemask1 - */
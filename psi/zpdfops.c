@@ -1226,6 +1226,18 @@ static int apply_interpreter_params(i_ctx_t *i_ctx_p, pdfctx_t *pdfctx, ref *pdi
         pdfctx->ctx->args.preservedocview = pvalueref->value.boolval;
     }
 
+    if (dict_find_string(pdictref, "ImageCacheSize", &pvalueref) > 0) {
+        if (!r_has_type(pvalueref, t_integer))
+            goto error;
+        pdfctx->ctx->args.image_cache_size = pvalueref->value.intval;
+    }
+
+    if (dict_find_string(pdictref, "NoDCTScaling", &pvalueref) > 0) {
+        if (!r_has_type(pvalueref, t_boolean))
+            goto error;
+        pdfctx->ctx->args.nodctscaling = pvalueref->value.boolval;
+    }
+
     if (dict_find_string(pdictref, "NoUserUnit", &pvalueref) > 0) {
         if (!r_has_type(pvalueref, t_boolean))
             goto error;
@@ -1315,6 +1327,17 @@ static int apply_interpreter_params(i_ctx_t *i_ctx_p, pdfctx_t *pdfctx, ref *pdi
             goto error;
         pdfctx->ctx->args.nonativefontmap = pvalueref->value.boolval;
     }
+    if (dict_find_string(pdictref, "NativeFontMapCache", &pvalueref) > 0) {
+        if (!r_has_type(pvalueref, t_string))
+            goto error;
+        pdfctx->ctx->args.nativefontmapcache.data = (byte *)gs_alloc_bytes(pdfctx->ctx->memory, r_size(pvalueref) + 1, "PDF nativefontmapcache from zpdfops");
+        if (pdfctx->ctx->args.nativefontmapcache.data == NULL) {
+            code = gs_note_error(gs_error_VMerror);
+            goto error;
+        }
+        memcpy(pdfctx->ctx->args.nativefontmapcache.data, pvalueref->value.const_bytes, r_size(pvalueref));
+        pdfctx->ctx->args.nativefontmapcache.size = r_size(pvalueref);
+    }
     if (dict_find_string(pdictref, "PageCount", &pvalueref) > 0) {
         if (!r_has_type(pvalueref, t_integer))
             goto error;
@@ -477,6 +477,14 @@ current_VMThreshold(i_ctx_t *i_ctx_p)
     return stat.vm_threshold;
 }
 static long
+current_VMThresholdGrowth(i_ctx_t *i_ctx_p)
+{
+    gs_memory_gc_status_t stat;
+
+    gs_memory_gc_status(iimemory_local, &stat);
+    return stat.vm_growth;
+}
+static long
 current_WaitTimeout(i_ctx_t *i_ctx_p)
 {
     return 0;
@@ -652,7 +660,9 @@ static const long_param_def_t user_long_params[] =
     {"AlignToPixels", 0, 1,
      current_AlignToPixels, set_AlignToPixels},
     {"GridFitTT", 0, 3,
-     current_GridFitTT, set_GridFitTT}
+     current_GridFitTT, set_GridFitTT},
+    {"VMThresholdGrowth", 0, MAX_VM_GROWTH,
+     current_VMThresholdGrowth, set_vm_growth}
 };
 
 /* Note that string objects that are maintained as user params must be
@@ -91,6 +91,15 @@ set_vm_threshold(i_ctx_t *i_ctx_p, int64_t val)
     return 0;
 }
 
+int
+set_vm_growth(i_ctx_t *i_ctx_p, long val)
+{
+    gs_memory_set_vm_growth(idmemory->space_system, (int)val);
+    gs_memory_set_vm_growth(idmemory->space_global, (int)val);
+    gs_memory_set_vm_growth(idmemory->space_local, (int)val);
+    return 0;
+}
+
 int
 set_vm_reclaim(i_ctx_t *i_ctx_p, long val)
 {
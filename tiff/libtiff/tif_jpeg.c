@@ -1447,6 +1447,13 @@ int TIFFJPEGIsFullStripRequired(TIFF *tif)
     {
         /* Use normal interface to libjpeg */
         sp->cinfo.d.raw_data_out = FALSE;
+#if JPEG_LIB_VERSION >= 90
+        /* Ghostscript builds IJG 9 with IDCT_SCALING_SUPPORTED, for which
+         * "fancy" upsampling means scaling chroma up through the IDCT.
+         * Keep the replicating upsampler, which is what this library used
+         * before IDCT scaling was enabled (and all it has without it). */
+        sp->cinfo.d.do_fancy_upsampling = FALSE;
+#endif
         tif->tif_decoderow = JPEGDecode;
         tif->tif_decodestrip = JPEGDecode;
         tif->tif_decodetile = JPEGDecode;